@@ -0,0 +1,144 @@
+/***********************************************************************
+* Component:
+*    Week 13, Arena
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the Arena class
+************************************************************************/
+
+#include "arena.h"
+#include <cassert>
+#include <new>
+
+/******************************************************************************
+ * ARENA CONSTRUCTOR
+ * An empty arena that takes chunks of at least in_chunkSize bytes
+ ******************************************************************************/
+Arena::Arena(size_t in_chunkSize)
+   : m_next(NULL), m_limit(NULL), m_chunkSize(in_chunkSize), m_bytesHeld(0)
+{
+   assert(m_chunkSize > 0);
+   m_stats.allocations = 0;
+   m_stats.chunks = 0;
+   m_stats.bytesInUse = 0;
+   m_stats.peakBytes = 0;
+}
+
+/******************************************************************************
+ * ARENA ALLOCATE
+ * Returns in_bytes of memory aligned to in_align, a power of two, reusing a
+ * block that was given back when there is one
+ ******************************************************************************/
+void * Arena::allocate(size_t in_bytes, size_t in_align)
+{
+   assert(in_align > 0 && (in_align & (in_align - 1)) == 0);
+
+   // reuse a block of this size that was given back, if it is aligned
+   int list = freeList(in_bytes);
+   if (list >= 0 && !m_free[list].empty() &&
+       (size_t)m_free[list].back() % in_align == 0)
+   {
+      void * p = m_free[list].back();
+      m_free[list].pop_back();
+      m_stats.allocations++;
+      m_stats.bytesInUse += in_bytes;
+      return p;
+   }
+
+   size_t padding = (in_align - (size_t)m_next % in_align) % in_align;
+   if (m_next == NULL || (size_t)(m_limit - m_next) < padding + in_bytes)
+   {
+      addChunk(in_bytes + in_align);
+      padding = (in_align - (size_t)m_next % in_align) % in_align;
+   }
+
+   void * p = m_next + padding;
+   m_next += padding + in_bytes;
+   m_stats.allocations++;
+   m_stats.bytesInUse += in_bytes;
+   return p;
+}
+
+/******************************************************************************
+ * ARENA DEALLOCATE
+ * Gives back a block from allocate() to be handed out again. Only blocks
+ * whose size is a power of two are kept; the rest wait for release().
+ ******************************************************************************/
+void Arena::deallocate(void * in_block, size_t in_bytes)
+{
+   if (in_block == NULL)
+      return;
+   m_stats.bytesInUse -= in_bytes;
+
+   int list = freeList(in_bytes);
+   if (list >= 0)
+      m_free[list].push_back(in_block);
+}
+
+/******************************************************************************
+ * ARENA RESERVE
+ * Makes sure the next in_bytes of allocations fit in the current chunk, so
+ * that data of a known size is laid out together
+ ******************************************************************************/
+void Arena::reserve(size_t in_bytes)
+{
+   if (m_next == NULL || (size_t)(m_limit - m_next) < in_bytes)
+      addChunk(in_bytes);
+}
+
+/******************************************************************************
+ * ARENA RELEASE
+ * Frees every chunk. Everything allocate() has handed out is then invalid.
+ ******************************************************************************/
+void Arena::release()
+{
+   for (size_t i = 0; i < m_chunks.size(); i++)
+      delete[] m_chunks[i];
+   m_chunks.clear();
+   for (int i = 0; i < ARENA_FREE_LISTS; i++)
+      m_free[i].clear();
+   m_next = NULL;
+   m_limit = NULL;
+   m_bytesHeld = 0;
+   m_stats.bytesInUse = 0;
+}
+
+/******************************************************************************
+ * ARENA ADD CHUNK
+ * Takes a new chunk of at least in_bytes from the heap and allocates from it
+ * from now on. Whatever was left of the previous chunk goes unused.
+ ******************************************************************************/
+void Arena::addChunk(size_t in_bytes)
+{
+   size_t size = in_bytes > m_chunkSize ? in_bytes : m_chunkSize;
+   char * chunk;
+   try
+   {
+      chunk = new char[size];
+   }
+   catch (std::bad_alloc)
+   {
+      throw "ERROR: Unable to allocate a new chunk for Arena.";
+   }
+
+   m_chunks.push_back(chunk);
+   m_next = chunk;
+   m_limit = chunk + size;
+   m_bytesHeld += size;
+   m_stats.chunks++;
+   if (m_bytesHeld > m_stats.peakBytes)
+      m_stats.peakBytes = m_bytesHeld;
+}
+
+/******************************************************************************
+ * ARENA FREE LIST
+ * Which free list holds blocks of in_bytes, or -1 if they aren't recycled
+ ******************************************************************************/
+int Arena::freeList(size_t in_bytes)
+{
+   for (int i = 0; i < ARENA_FREE_LISTS; i++)
+      if (in_bytes == (size_t)1 << i)
+         return i;
+   return -1;
+}
@@ -0,0 +1,71 @@
+/***********************************************************************
+* Component:
+*    Week 13, Arena
+* Author:
+*    Matthew Burr
+* Summary:
+*    A bump allocator that hands out memory from large chunks and frees
+*    all of it at once
+************************************************************************/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_FREE_LISTS 16     // blocks of 1 up to 32K bytes are recycled
+
+/******************************************************************************
+ * ARENA STATS
+ * What an Arena has done since it was created
+ ******************************************************************************/
+struct ArenaStats
+{
+   int allocations;      // calls to allocate()
+   int chunks;           // chunks taken from the heap
+   size_t bytesInUse;    // bytes handed out and not given back
+   size_t peakBytes;     // the most bytes ever held in chunks at once
+};
+
+/******************************************************************************
+ * ARENA
+ * Hands out memory by moving a pointer through a chunk, taking a new chunk
+ * from the heap when one fills up. Nothing goes back to the heap on its own:
+ * release() (or the destructor) frees every chunk in one go, so it suits
+ * data that lives and dies together. A block whose size is a power of two
+ * can be given back with deallocate() and is handed out again to the next
+ * request of that size, which suits the doubling buffers of a growing Set.
+ * No destructors are run, so only objects that need none belong in an
+ * Arena. Not safe to use from more than one thread at a time.
+ ******************************************************************************/
+class Arena
+{
+public:
+   Arena(size_t in_chunkSize = ARENA_CHUNK_SIZE);
+   ~Arena() { release(); }
+
+   void * allocate(size_t in_bytes, size_t in_align);
+   void deallocate(void * in_block, size_t in_bytes);
+   void reserve(size_t in_bytes);
+   void release();
+   const ArenaStats & stats() const { return m_stats; }
+
+private:
+   Arena(const Arena &);
+   Arena & operator = (const Arena &);
+
+   void addChunk(size_t in_bytes);
+   static int freeList(size_t in_bytes);
+
+   std::vector<char *> m_chunks;
+   char * m_next;          // the next free byte in the current chunk
+   char * m_limit;         // the end of the current chunk
+   size_t m_chunkSize;
+   size_t m_bytesHeld;     // the total size of m_chunks
+   std::vector<void *> m_free[ARENA_FREE_LISTS];  // given back, by size
+   ArenaStats m_stats;
+};
+
+#endif // ARENA_H
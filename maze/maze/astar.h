@@ -0,0 +1,132 @@
+/***********************************************************************
+* Component:
+*    Week 13, A* Search
+* Author:
+*    Matthew Burr
+* Summary:
+*    Finds the shortest path through a Graph with A*, guided by a
+*    heuristic that estimates the distance remaining to the goal
+************************************************************************/
+
+#ifndef ASTAR_H
+#define ASTAR_H
+
+#include "graph.h"
+#include "vertex.h"
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+/******************************************************************************
+ * MANHATTAN HEURISTIC
+ * Estimates the distance between two cells of a maze in_numCol cells wide as
+ * the number of rows plus the number of columns between them. Every edge in a
+ * maze moves one cell, so this never overestimates.
+ ******************************************************************************/
+class ManhattanHeuristic
+{
+public:
+   ManhattanHeuristic(int in_numCol) : m_numCol(in_numCol) { assert(m_numCol > 0); }
+
+   int operator () (int in_from, int in_to) const
+   {
+      int rows = in_from / m_numCol - in_to / m_numCol;
+      int cols = in_from % m_numCol - in_to % m_numCol;
+      return (rows < 0 ? -rows : rows) + (cols < 0 ? -cols : cols);
+   }
+
+private:
+   int m_numCol;
+};
+
+/******************************************************************************
+ * A STAR ENTRY
+ * One entry in the A* open list. Entries are ordered so that the heap top
+ * has the lowest estimate, and among equal estimates the one furthest from
+ * the start (which is closest to finishing).
+ ******************************************************************************/
+struct AStarEntry
+{
+   int estimate;   // distance so far plus the heuristic
+   int distance;   // distance from the start
+   VertexId vertex;
+
+   bool operator < (const AStarEntry & rhs) const
+   {
+      if (estimate != rhs.estimate)
+         return estimate > rhs.estimate;
+      return distance < rhs.distance;
+   }
+};
+
+/******************************************************************************
+ * FIND PATH A STAR
+ * Finds the shortest path from in_start to in_end in a Graph or GridGraph,
+ * expanding vertices in order of distance travelled plus
+ * in_heuristic(vertex, end). The heuristic must never overestimate. The open
+ * list is a binary heap in one contiguous array; a vertex reached again by a
+ * shorter route is simply pushed again, and the stale entry is skipped when
+ * it surfaces. Like Graph::findPath, the path runs from in_end back to
+ * in_start, and out_expanded receives the number of vertices expanded.
+ ******************************************************************************/
+template <class G, class Heuristic>
+std::vector<Vertex> findPathAStar(const G & in_graph,
+                                  const Vertex & in_start,
+                                  const Vertex & in_end,
+                                  Heuristic in_heuristic,
+                                  int & out_expanded)
+{
+   assert(in_start.index() >= 0 && in_start.index() < in_graph.size());
+   assert(in_end.index() >= 0 && in_end.index() < in_graph.size());
+
+   int goal = in_end.index();
+   std::vector<int> distances(in_graph.size(), -1);
+   std::vector<VertexId> predecessor(in_graph.size(), -1);
+   std::vector<AStarEntry> open;
+   out_expanded = 0;
+
+   AStarEntry first = { in_heuristic(in_start.index(), goal), 0,
+                        in_start.index() };
+   distances[in_start.index()] = 0;
+   open.push_back(first);
+
+   while (!open.empty())
+   {
+      std::pop_heap(open.begin(), open.end());
+      AStarEntry current = open.back();
+      open.pop_back();
+
+      // a shorter route to this vertex was found after this entry was pushed
+      if (current.distance > distances[current.vertex])
+         continue;
+
+      if (current.vertex == goal)
+         break;
+      out_expanded++;
+
+      in_graph.forEachNeighbor(current.vertex, [&](int next)
+      {
+         int distance = current.distance + 1;
+         if (distances[next] == -1 || distance < distances[next])
+         {
+            distances[next] = distance;
+            predecessor[next] = current.vertex;
+            AStarEntry entry = { distance + in_heuristic(next, goal),
+                                 distance, next };
+            open.push_back(entry);
+            std::push_heap(open.begin(), open.end());
+         }
+      });
+   }
+
+   if (distances[goal] == -1)
+      throw "ERROR: No path from source to destination.";
+
+   std::vector<Vertex> path;
+   path.push_back(in_end);
+   for (int v = goal; v != in_start.index(); v = predecessor[v])
+      path.push_back(Vertex::fromIndex(predecessor[v]));
+   return path;
+}
+
+#endif // ASTAR_H
@@ -0,0 +1,172 @@
+/***********************************************************************
+* Component:
+*    Week 13, Batch Solver
+* Author:
+*    Matthew Burr
+* Summary:
+*    Answers large batches of path and distance queries across many
+*    threads
+************************************************************************/
+
+#include "batchSolver.h"
+#include <cassert>
+#include <cstdio>
+#include <string>
+using namespace std;
+
+// queries handed to a worker at a time; small enough to balance the load,
+// large enough that taking a task costs little next to the searches in it
+#define QUERIES_PER_TASK 64
+
+// distance rows held in memory at once, per thread
+#define ROWS_PER_THREAD 4
+
+template <class G>
+void solveInParallel(const G & in_graph,
+                     const vector<PathQuery> & in_queries,
+                     vector< vector<Vertex> > & out_paths,
+                     ThreadPool & in_pool);
+
+/******************************************************************************
+ * FIND PATHS PARALLEL
+ * Answers every query in a Graph on in_pool's threads
+ ******************************************************************************/
+void findPathsParallel(const Graph & in_graph,
+                       const vector<PathQuery> & in_queries,
+                       vector< vector<Vertex> > & out_paths,
+                       ThreadPool & in_pool)
+{
+   solveInParallel(in_graph, in_queries, out_paths, in_pool);
+}
+
+/******************************************************************************
+ * FIND PATHS PARALLEL
+ * Answers every query in a GridGraph on in_pool's threads
+ ******************************************************************************/
+void findPathsParallel(const GridGraph & in_graph,
+                       const vector<PathQuery> & in_queries,
+                       vector< vector<Vertex> > & out_paths,
+                       ThreadPool & in_pool)
+{
+   solveInParallel(in_graph, in_queries, out_paths, in_pool);
+}
+
+/******************************************************************************
+ * SOLVE IN PARALLEL
+ * Splits the queries into small tasks on in_pool. Each worker keeps its own
+ * PathFinder, so its search buffers are allocated once and reused for every
+ * query it runs, and idle workers steal tasks from busy ones. Reading a
+ * graph from many threads at once is safe as long as nothing modifies it
+ * until this returns. Like PathFinder::findPaths, a
+ * query with no path gets an empty path.
+ ******************************************************************************/
+template <class G>
+void solveInParallel(const G & in_graph,
+                     const vector<PathQuery> & in_queries,
+                     vector< vector<Vertex> > & out_paths,
+                     ThreadPool & in_pool)
+{
+   out_paths.assign(in_queries.size(), vector<Vertex>());
+
+   // the scratch state for each worker, created by that worker when needed
+   vector<PathFinder *> finders(in_pool.size(), (PathFinder *)NULL);
+
+   for (size_t first = 0; first < in_queries.size(); first += QUERIES_PER_TASK)
+   {
+      size_t last = first + QUERIES_PER_TASK;
+      if (last > in_queries.size())
+         last = in_queries.size();
+
+      in_pool.submit([&, first, last](int worker)
+      {
+         if (finders[worker] == NULL)
+            finders[worker] = new PathFinder(in_graph);
+
+         PathFinder & finder = *finders[worker];
+         for (size_t i = first; i < last; ++i)
+         {
+            try
+            {
+               out_paths[i] = finder.findPath(in_queries[i].first,
+                                              in_queries[i].second);
+            }
+            catch (const char *)
+            {
+               // no path; leave this one empty
+            }
+         }
+      });
+   }
+   in_pool.wait();
+
+   for (size_t i = 0; i < finders.size(); ++i)
+      delete finders[i];
+}
+
+/******************************************************************************
+ * ALL PAIRS DISTANCES
+ * Runs a breadth-first search from every vertex of in_graph in turn, on
+ * in_pool's threads, and hands each source's distances to in_visit in
+ * source order. Sources go out a block at a time and each block's rows are
+ * handed over before the next starts, so only a few rows per thread are
+ * ever in memory, not all V * V distances. Each worker keeps one search
+ * queue for every source it runs. in_visit runs on the calling thread, so
+ * it needs no locking of its own.
+ ******************************************************************************/
+void allPairsDistances(const Graph & in_graph, ThreadPool & in_pool,
+                       const DistanceRowVisitor & in_visit)
+{
+   int numRows = in_pool.size() * ROWS_PER_THREAD;
+   vector< vector<int> > rows(numRows);
+   vector< vector<VertexId> > queues(in_pool.size());
+
+   for (int first = 0; first < in_graph.size(); first += numRows)
+   {
+      int last = first + numRows;
+      if (last > in_graph.size())
+         last = in_graph.size();
+
+      for (int source = first; source < last; ++source)
+         in_pool.submit([&, source](int worker)
+         {
+            in_graph.distancesFrom(Vertex::fromIndex(source),
+                                   rows[source - first], queues[worker]);
+         });
+      in_pool.wait();
+
+      for (int source = first; source < last; ++source)
+         in_visit(source, rows[source - first]);
+   }
+}
+
+/******************************************************************************
+ * WRITE ALL PAIRS DISTANCES
+ * Writes the distance between every pair of vertices to in_fileName as
+ * text: one line per source vertex, holding its distance to each vertex in
+ * order, with -1 where there is no path. Returns false if the file can't
+ * be written.
+ ******************************************************************************/
+bool writeAllPairsDistances(const Graph & in_graph, const char * in_fileName,
+                            ThreadPool & in_pool)
+{
+   FILE * file = fopen(in_fileName, "w");
+   if (file == NULL)
+      return false;
+
+   bool isOk = true;
+   string line;
+   allPairsDistances(in_graph, in_pool, [&](int source, const vector<int> & row)
+   {
+      line.clear();
+      char number[16];
+      for (size_t i = 0; i < row.size(); ++i)
+      {
+         int length = sprintf(number, i ? " %d" : "%d", row[i]);
+         line.append(number, length);
+      }
+      line += '\n';
+      isOk = isOk && fwrite(line.data(), 1, line.size(), file) == line.size();
+   });
+
+   return fclose(file) == 0 && isOk;
+}
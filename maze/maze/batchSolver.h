@@ -0,0 +1,40 @@
+/***********************************************************************
+* Component:
+*    Week 13, Batch Solver
+* Author:
+*    Matthew Burr
+* Summary:
+*    Answers large batches of path and distance queries across many
+*    threads
+************************************************************************/
+
+#ifndef BATCHSOLVER_H
+#define BATCHSOLVER_H
+
+#include "graph.h"
+#include "gridGraph.h"
+#include "pathFinder.h"
+#include "threadPool.h"
+#include <functional>
+#include <vector>
+
+// answer every query on in_pool's threads, one path per query in order
+void findPathsParallel(const Graph & in_graph,
+                       const std::vector<PathQuery> & in_queries,
+                       std::vector< std::vector<Vertex> > & out_paths,
+                       ThreadPool & in_pool);
+void findPathsParallel(const GridGraph & in_graph,
+                       const std::vector<PathQuery> & in_queries,
+                       std::vector< std::vector<Vertex> > & out_paths,
+                       ThreadPool & in_pool);
+
+// called with each source vertex's index and its distance to every vertex
+typedef std::function<void(int, const std::vector<int> &)> DistanceRowVisitor;
+
+// the distances between every pair of vertices, one source at a time
+void allPairsDistances(const Graph & in_graph, ThreadPool & in_pool,
+                       const DistanceRowVisitor & in_visit);
+bool writeAllPairsDistances(const Graph & in_graph, const char * in_fileName,
+                            ThreadPool & in_pool);
+
+#endif // BATCHSOLVER_H
@@ -0,0 +1,369 @@
+/***********************************************************************
+* Component:
+*    Week 13, Benchmarks
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the benchmarks behind the driver's timing options
+************************************************************************/
+
+#include "benchmarks.h"
+#include "dynamicPaths.h"
+#include "graph.h"
+#include "mappedFile.h"
+#include "maze.h"
+#include "mazeGenerator.h"
+#include "mazeParser.h"
+#include "setKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// every benchmark starts from the same random numbers, so runs compare
+#define BENCHMARK_SEED 235
+
+typedef chrono::steady_clock Clock;
+
+// seconds from in_start until now
+static double secondsSince(Clock::time_point in_start)
+{
+   return chrono::duration<double>(Clock::now() - in_start).count();
+}
+
+/******************************************************************************
+ * READ EDGES STREAM
+ * Reads a maze's edges the way readMaze used to: through ifstream, with a
+ * std::string and a virtual setText call for every coordinate
+ ******************************************************************************/
+static bool readEdgesStream(const char * in_fileName, vector<Edge> & out_edges)
+{
+   ifstream fin(in_fileName);
+   int numCol;
+   int numRow;
+   if (!(fin >> numCol >> numRow) || numCol <= 0 || numRow <= 0)
+      return false;
+   CVertex vFrom;
+   CVertex vTo;
+   vFrom.setMax(numCol, numRow);
+
+   out_edges.clear();
+   while (fin >> vFrom >> vTo)
+   {
+      Edge edge = { vFrom.index(), vTo.index() };
+      out_edges.push_back(edge);
+   }
+   return true;
+}
+
+/******************************************************************************
+ * READ EDGES PARSER
+ * Reads a maze's edges the way readMaze does now: mapped into memory and
+ * tokenized in place by MazeParser
+ ******************************************************************************/
+static bool readEdgesParser(const char * in_fileName, vector<Edge> & out_edges)
+{
+   MappedFile file(in_fileName);
+   MazeParser parser(file.begin(), file.end());
+   int numCol;
+   int numRow;
+   if (!file.isOpen() || !parser.readSize(numCol, numRow))
+      return false;
+
+   out_edges.clear();
+   Edge edge;
+   while (parser.readEdge(edge.from, edge.to))
+      out_edges.push_back(edge);
+   return true;
+}
+
+// a sorted array operation with the signature of the set kernels
+typedef int (*SetOperation)(const int *, int, const int *, int, int *);
+
+/******************************************************************************
+ * INTERSECT / UNITE / SUBTRACT MERGE
+ * The plain std::set_* merges the kernels are measured against
+ ******************************************************************************/
+static int intersectMerge(const int * in_a, int in_numA,
+                          const int * in_b, int in_numB, int * out_result)
+{
+   return (int)(set_intersection(in_a, in_a + in_numA, in_b, in_b + in_numB,
+                                 out_result) - out_result);
+}
+
+static int uniteMerge(const int * in_a, int in_numA,
+                      const int * in_b, int in_numB, int * out_result)
+{
+   return (int)(set_union(in_a, in_a + in_numA, in_b, in_b + in_numB,
+                          out_result) - out_result);
+}
+
+static int subtractMerge(const int * in_a, int in_numA,
+                         const int * in_b, int in_numB, int * out_result)
+{
+   return (int)(set_difference(in_a, in_a + in_numA, in_b, in_b + in_numB,
+                               out_result) - out_result);
+}
+
+/******************************************************************************
+ * TIME SET OPERATION
+ * Runs in_operation in_numTimes on in_a and in_b into out_result, returning
+ * the seconds it took and leaving the size of the result in out_num
+ ******************************************************************************/
+static double timeSetOperation(SetOperation in_operation,
+                               const vector<int> & in_a,
+                               const vector<int> & in_b, int in_numTimes,
+                               vector<int> & out_result, int & out_num)
+{
+   Clock::time_point start = Clock::now();
+   for (int time = 0; time < in_numTimes; ++time)
+      out_num = in_operation(in_a.data(), (int)in_a.size(),
+                             in_b.data(), (int)in_b.size(), out_result.data());
+   return secondsSince(start);
+}
+
+/******************************************************************************
+ * BENCHMARK DYNAMIC PATHS
+ * Makes a perfect maze of the size asked for and picks passages to carve
+ * into it at random, east or south from a random cell. One copy carves
+ * them through DynamicShortestPaths, which repairs the distances from the
+ * top-left cell as it goes; the other adds each to the Graph and runs
+ * distancesFrom over the whole maze again, reusing its storage. Both pay
+ * for the same Graph::add calls, so the difference is the repair against
+ * the search. Reports both times and whether the distances agree at the end.
+ ******************************************************************************/
+void benchmarkDynamicPaths()
+{
+   int numCol;
+   int numRow;
+   int numCarves;
+   cout << "How many columns and rows? ";
+   cin >> numCol >> numRow;
+   cout << "How many passages to carve? ";
+   cin >> numCarves;
+   if (!cin || numCol < 1 || numRow < 1 || numCarves < 0 ||
+       (long long)numCol * numRow > INT_MAX)
+   {
+      cout << "ERROR: Unrecognized benchmark options\n";
+      return;
+   }
+
+   MazeGenerator generator(numCol, numRow, BENCHMARK_SEED);
+   Graph repaired = generator.generate(MAZE_KRUSKAL);
+   Graph solved(repaired);
+   Vertex source = Vertex::fromIndex(0);
+
+   // pick the passages up front so both copies carve the same ones; some
+   // will already be open, which costs both sides the same nothing
+   vector<Edge> carves;
+   mt19937 random(BENCHMARK_SEED);
+   int numCells = numCol * numRow;
+   while ((int)carves.size() < numCarves && numCells > 1)
+   {
+      int cell = (int)(random() % numCells);
+      bool isEast = (random() & 1) != 0;
+      if (isEast ? cell % numCol + 1 == numCol : cell / numCol + 1 == numRow)
+         continue;
+      Edge carve = { cell, isEast ? cell + 1 : cell + numCol };
+      carves.push_back(carve);
+   }
+
+   Clock::time_point start = Clock::now();
+   DynamicShortestPaths paths(repaired, source);
+   double first = secondsSince(start);
+
+   long long touched = 0;
+   start = Clock::now();
+   for (size_t i = 0; i < carves.size(); ++i)
+   {
+      Vertex from = Vertex::fromIndex(carves[i].from);
+      Vertex to = Vertex::fromIndex(carves[i].to);
+      paths.add(from, to);
+      touched += paths.touched();
+      paths.add(to, from);
+      touched += paths.touched();
+   }
+   double repair = secondsSince(start);
+
+   vector<int> distances;
+   vector<VertexId> queue;
+   start = Clock::now();
+   for (size_t i = 0; i < carves.size(); ++i)
+   {
+      Vertex from = Vertex::fromIndex(carves[i].from);
+      Vertex to = Vertex::fromIndex(carves[i].to);
+      solved.add(from, to);
+      solved.add(to, from);
+      solved.distancesFrom(source, distances, queue);
+   }
+   double solve = secondsSince(start);
+   if (carves.empty())
+      solved.distancesFrom(source, distances, queue);
+
+   bool isSame = true;
+   for (int v = 0; v < numCells; ++v)
+      isSame = isSame && paths.distance(Vertex::fromIndex(v)) == distances[v];
+
+   cout << "The first search took " << first << "s\n";
+   cout << "Repairing after " << carves.size() << " passages took "
+        << repair << "s, shortening " << touched << " distances\n";
+   cout << "Searching again after each took " << solve << "s\n";
+   if (repair > 0)
+      cout << "Repairing was " << solve / repair << " times as fast\n";
+   cout << (isSame ? "The distances agree\n"
+                   : "ERROR: The distances disagree\n");
+}
+
+/******************************************************************************
+ * BENCHMARK PARSER
+ * Reads each text maze asked for the given number of times, first through
+ * the old ifstream >> CVertex loop and then through MazeParser, both into
+ * the same edge list so only the reading differs. Reports both times, the
+ * speedup, and whether they found the same edges.
+ ******************************************************************************/
+void benchmarkParser()
+{
+   string line;
+   int numTimes;
+   cout << "What are the filenames? ";
+   getline(cin >> ws, line);
+   cout << "How many times to read each? ";
+   cin >> numTimes;
+
+   vector<string> fileNames;
+   istringstream words(line);
+   string fileName;
+   while (words >> fileName)
+      fileNames.push_back(fileName);
+   if (!cin || numTimes < 1 || fileNames.empty())
+   {
+      cout << "ERROR: Unrecognized benchmark options\n";
+      return;
+   }
+
+   vector<Edge> streamEdges;
+   vector<Edge> parserEdges;
+   bool isSame = true;
+   long long numEdges = 0;
+   double streamTime = 0;
+   double parserTime = 0;
+   for (size_t i = 0; i < fileNames.size(); ++i)
+   {
+      const char * name = fileNames[i].c_str();
+      Clock::time_point start = Clock::now();
+      for (int time = 0; time < numTimes; ++time)
+         if (!readEdgesStream(name, streamEdges))
+         {
+            cout << "ERROR: Unable to read " << name << endl;
+            return;
+         }
+      streamTime += secondsSince(start);
+
+      start = Clock::now();
+      for (int time = 0; time < numTimes; ++time)
+         if (!readEdgesParser(name, parserEdges))
+         {
+            cout << "ERROR: Unable to read " << name << endl;
+            return;
+         }
+      parserTime += secondsSince(start);
+
+      numEdges += (long long)parserEdges.size() * numTimes;
+      isSame = isSame && streamEdges.size() == parserEdges.size();
+      for (size_t j = 0; isSame && j < parserEdges.size(); ++j)
+         isSame = streamEdges[j].from == parserEdges[j].from &&
+                  streamEdges[j].to == parserEdges[j].to;
+   }
+
+   cout << "Read " << numEdges << " edges from " << fileNames.size()
+        << " files " << numTimes << " times each\n";
+   cout << "ifstream >> CVertex took " << streamTime << "s\n";
+   cout << "MazeParser took " << parserTime << "s\n";
+   if (parserTime > 0)
+      cout << "MazeParser was " << streamTime / parserTime
+           << " times as fast\n";
+   cout << (isSame ? "The edges agree\n" : "ERROR: The edges disagree\n");
+}
+
+/******************************************************************************
+ * BENCHMARK SET KERNELS
+ * Builds a random sorted set of the size asked for and, for each ratio in
+ * turn, a smaller one about half of which it shares. Times &&, || and -
+ * of the smaller set with the larger through the set kernels Set<int> uses
+ * and through a plain std::set_* merge, each the given number of times, and
+ * checks that the two agree. The ratios straddle SET_KERNEL_VECTOR_RATIO
+ * and SET_KERNEL_GALLOP_RATIO, so each way the kernels merge is measured.
+ ******************************************************************************/
+void benchmarkSetKernels()
+{
+   int numValues;
+   int numTimes;
+   cout << "How many values in the larger set? ";
+   cin >> numValues;
+   cout << "How many times to run each? ";
+   cin >> numTimes;
+   if (!cin || numValues < 1 || numTimes < 1 || numValues > INT_MAX / 8)
+   {
+      cout << "ERROR: Unrecognized benchmark options\n";
+      return;
+   }
+
+   // values about four apart, so a random one is in the set a quarter of
+   // the time
+   mt19937 random(BENCHMARK_SEED);
+   vector<int> larger(numValues);
+   int value = 0;
+   for (int i = 0; i < numValues; ++i)
+      larger[i] = value += 1 + (int)(random() % 7);
+
+   const int ratios[] = { 1, 4, 32, 128, 1000 };
+   const char * names[] = { "&&", "||", "-" };
+   SetOperation kernelOperations[] = { intersectSorted, uniteSorted,
+                                       subtractSorted };
+   SetOperation mergeOperations[] = { intersectMerge, uniteMerge,
+                                      subtractMerge };
+
+   cout << "Using the " << setKernelName() << " kernels\n";
+   vector<int> kernelResult(2 * numValues);
+   vector<int> mergeResult(2 * numValues);
+   bool isSame = true;
+   for (size_t r = 0; r < sizeof(ratios) / sizeof(ratios[0]); ++r)
+   {
+      vector<int> smaller;
+      for (int i = 0; i < numValues / ratios[r]; ++i)
+         smaller.push_back(random() & 1 ? larger[random() % numValues]
+                                        : (int)(random() % (value + 1)));
+      sort(smaller.begin(), smaller.end());
+      smaller.erase(unique(smaller.begin(), smaller.end()), smaller.end());
+
+      cout << "1:" << ratios[r] << ", " << smaller.size() << " and "
+           << numValues << " values\n";
+      for (int op = 0; op < 3; ++op)
+      {
+         int numKernel = 0;
+         int numMerge = 0;
+         double kernelTime = timeSetOperation(kernelOperations[op], smaller,
+                                              larger, numTimes, kernelResult,
+                                              numKernel);
+         double mergeTime = timeSetOperation(mergeOperations[op], smaller,
+                                             larger, numTimes, mergeResult,
+                                             numMerge);
+         isSame = isSame && numKernel == numMerge &&
+                  equal(kernelResult.begin(), kernelResult.begin() + numKernel,
+                        mergeResult.begin());
+
+         cout << "\t" << names[op] << ": merge " << mergeTime
+              << "s, kernels " << kernelTime << "s";
+         if (kernelTime > 0)
+            cout << ", " << mergeTime / kernelTime << " times as fast";
+         cout << endl;
+      }
+   }
+   cout << (isSame ? "The results agree\n" : "ERROR: The results disagree\n");
+}
@@ -0,0 +1,26 @@
+/***********************************************************************
+* Component:
+*    Week 13, Benchmarks
+* Author:
+*    Matthew Burr
+* Summary:
+*    Times the faster ways of doing things against the ways they
+*    replaced, on the same input, and checks that they agree
+************************************************************************/
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+// carve passages into a maze one at a time, repairing the distances from
+// the corner each time against searching the whole maze again
+void benchmarkDynamicPaths();
+
+// read text mazes over and over, through MazeParser and through the
+// ifstream >> CVertex loop it replaced
+void benchmarkParser();
+
+// time Set<int>'s &&, || and - kernels against a plain merge, with the
+// smaller set from the same size as the larger to a thousandth of it
+void benchmarkSetKernels();
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,150 @@
+/***********************************************************************
+* Component:
+*    Week 13, Connectivity Oracle
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the ConnectivityOracle class
+************************************************************************/
+
+#include "connectivityOracle.h"
+#include <cassert>
+using namespace std;
+
+/******************************************************************************
+ * CONNECTIVITY ORACLE CONSTRUCTOR
+ * Indexes the incoming edges of in_graph and grows the tree of everything
+ * reachable from in_source
+ ******************************************************************************/
+ConnectivityOracle::ConnectivityOracle(Graph & in_graph,
+                                       const Vertex & in_source)
+   : m_graph(in_graph), m_source(in_source.index()),
+     m_inEdges(in_graph.size()),
+     m_parent(in_graph.size(), -1), m_firstChild(in_graph.size(), -1),
+     m_nextSibling(in_graph.size(), -1), m_prevSibling(in_graph.size(), -1),
+     m_queue(in_graph.size()), m_numConnected(1), m_touched(0)
+{
+   assert(m_source >= 0 && m_source < in_graph.size());
+
+   // sources are visited in order, so each set is only ever appended to
+   for (int v = 0; v < in_graph.size(); ++v)
+      in_graph.forEachNeighbor(v, [&](int w)
+      {
+         m_inEdges[w].insert(v);
+      });
+
+   m_parent[m_source] = m_source;
+   reach(m_source);
+}
+
+/******************************************************************************
+ * CONNECTIVITY ORACLE REMOVE
+ * Removes the edge in_from --> in_to from the graph and repairs the tree.
+ * Everything that was under in_to is cut off; then each cut-off vertex with
+ * an edge in from a vertex still reached is hung from it, bringing along
+ * whatever cut-off vertices it leads to. Nothing outside the cut can be
+ * newly reached, and nothing inside it can be reached any other way.
+ ******************************************************************************/
+void ConnectivityOracle::remove(Vertex & in_from, Vertex & in_to)
+{
+   int from = in_from.index();
+   int to = in_to.index();
+   m_touched = 0;
+
+   m_graph.remove(in_from, in_to);
+   VertexId key = from;
+   SetIterator<VertexId> it = m_inEdges[to].find(key);
+   if (it != m_inEdges[to].end())
+      m_inEdges[to].erase(it);
+
+   if (to == m_source || m_parent[to] != from)
+      return;
+
+   // cut off the subtree under in_to
+   detach(to);
+   m_cut.clear();
+   m_cut.push_back(to);
+   for (size_t i = 0; i < m_cut.size(); ++i)
+      for (int child = m_firstChild[m_cut[i]]; child != -1;
+           child = m_nextSibling[child])
+         m_cut.push_back(child);
+   for (size_t i = 0; i < m_cut.size(); ++i)
+   {
+      m_parent[m_cut[i]] = -1;
+      m_firstChild[m_cut[i]] = -1;
+   }
+   m_numConnected -= (int)m_cut.size();
+   m_touched = (int)m_cut.size();
+
+   // find the ways back in
+   for (size_t i = 0; i < m_cut.size(); ++i)
+   {
+      int v = m_cut[i];
+      if (m_parent[v] != -1)
+         continue;
+      const VertexId * p = m_inEdges[v].data();
+      for (int j = 0; j < m_inEdges[v].size(); ++j)
+         if (m_parent[p[j]] != -1)
+         {
+            attach(v, p[j]);
+            reach(v);
+            break;
+         }
+   }
+}
+
+/******************************************************************************
+ * CONNECTIVITY ORACLE ATTACH
+ * Hangs in_child, which has no parent, from in_parent
+ ******************************************************************************/
+void ConnectivityOracle::attach(int in_child, int in_parent)
+{
+   assert(m_parent[in_child] == -1);
+   m_parent[in_child] = in_parent;
+   m_prevSibling[in_child] = -1;
+   m_nextSibling[in_child] = m_firstChild[in_parent];
+   if (m_firstChild[in_parent] != -1)
+      m_prevSibling[m_firstChild[in_parent]] = in_child;
+   m_firstChild[in_parent] = in_child;
+   m_numConnected++;
+}
+
+/******************************************************************************
+ * CONNECTIVITY ORACLE DETACH
+ * Unhooks in_child from its parent's list of children
+ ******************************************************************************/
+void ConnectivityOracle::detach(int in_child)
+{
+   int next = m_nextSibling[in_child];
+   int prev = m_prevSibling[in_child];
+   if (prev != -1)
+      m_nextSibling[prev] = next;
+   else
+      m_firstChild[m_parent[in_child]] = next;
+   if (next != -1)
+      m_prevSibling[next] = prev;
+}
+
+/******************************************************************************
+ * CONNECTIVITY ORACLE REACH
+ * Breadth-first from in_from, which is in the tree, hanging every vertex
+ * it leads to that isn't in the tree from the vertex that found it
+ ******************************************************************************/
+void ConnectivityOracle::reach(int in_from)
+{
+   int head = 0;
+   int tail = 0;
+   m_queue[tail++] = in_from;
+   while (head < tail)
+   {
+      int v = m_queue[head++];
+      m_graph.forEachNeighbor(v, [&](int w)
+      {
+         if (m_parent[w] == -1)
+         {
+            attach(w, v);
+            m_queue[tail++] = w;
+         }
+      });
+   }
+}
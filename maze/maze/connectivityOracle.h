@@ -0,0 +1,68 @@
+/***********************************************************************
+* Component:
+*    Week 13, Connectivity Oracle
+* Author:
+*    Matthew Burr
+* Summary:
+*    Answers whether a vertex can still be reached from one source as
+*    edges are removed, without searching the whole graph again
+************************************************************************/
+
+#ifndef CONNECTIVITYORACLE_H
+#define CONNECTIVITYORACLE_H
+
+#include "graph.h"
+#include "vertex.h"
+#include <vector>
+
+/******************************************************************************
+ * CONNECTIVITY ORACLE
+ * A spanning tree of everything reachable from one source in a Graph, kept
+ * up to date as edges go out through remove(). Removing an edge the tree
+ * doesn't use changes nothing. Removing one it does cuts off a subtree,
+ * whose vertices look for another way in among their own incoming edges;
+ * those that find one take the rest of the subtree they can reach with
+ * them. Only the cut-off subtree and its edges are looked at, so a wall
+ * that cuts off a dead end costs about as much as the dead end. Whether a
+ * vertex is reachable is then one lookup. Keeps its own index of incoming
+ * edges, since a Graph being changed has none. The graph must not be
+ * changed other than through remove() while this is bound to it.
+ ******************************************************************************/
+class ConnectivityOracle
+{
+public:
+   ConnectivityOracle(Graph & in_graph, const Vertex & in_source);
+
+   void remove(Vertex & in_from, Vertex & in_to);
+
+   bool isConnected(const Vertex & in_end) const
+   {
+      return m_parent[in_end.index()] != -1;
+   }
+   int numConnected() const { return m_numConnected; }
+
+   // vertices cut off, for a while or for good, by the last remove()
+   int touched() const { return m_touched; }
+
+private:
+   ConnectivityOracle(const ConnectivityOracle &);
+   ConnectivityOracle & operator = (const ConnectivityOracle &);
+
+   void attach(int in_child, int in_parent);
+   void detach(int in_child);
+   void reach(int in_from);
+
+   Graph & m_graph;
+   int m_source;
+   std::vector<VertexIdSet> m_inEdges;   // the vertices with an edge to each
+   std::vector<VertexId> m_parent;       // -1 where there is no path
+   std::vector<VertexId> m_firstChild;   // the children of each vertex in
+   std::vector<VertexId> m_nextSibling;  // the tree, as a doubly linked
+   std::vector<VertexId> m_prevSibling;  // list; -1 ends it
+   std::vector<VertexId> m_queue;        // reused by every repair
+   std::vector<VertexId> m_cut;
+   int m_numConnected;
+   int m_touched;
+};
+
+#endif // CONNECTIVITYORACLE_H
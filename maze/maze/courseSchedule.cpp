@@ -0,0 +1,259 @@
+/***********************************************************************
+* Component:
+*    Week 13, Course Schedule
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements curriculum reading and scheduling
+************************************************************************/
+
+#include "courseSchedule.h"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+// curricula handed to a worker at a time; each is small, so a task takes
+// several to make taking it worthwhile
+#define CURRICULA_PER_TASK 16
+
+/******************************************************************************
+ * COURSE NAMES
+ * The name of every CourseVertex, by index, looked up once. Making a
+ * CourseVertex sets the shared Vertex max, so the first call has to come
+ * before other threads use vertices; scheduleCurricula makes it up front.
+ ******************************************************************************/
+static const vector<string> & courseNames()
+{
+   static vector<string> names;
+   if (names.empty())
+   {
+      CourseVertex course;
+      for (int i = 0; i < NUM_CLASS; ++i)
+      {
+         course = CourseVertex(Vertex::fromIndex(i));
+         names.push_back(course.getText());
+      }
+   }
+   return names;
+}
+
+// a CourseVertex index from its name, or -1
+static int findCourse(const string & in_name)
+{
+   const vector<string> & names = courseNames();
+   for (int i = 0; i < NUM_CLASS; ++i)
+      if (names[i] == in_name)
+         return i;
+   return -1;
+}
+
+/******************************************************************************
+ * READ CURRICULUM
+ * Reads the curriculum in in_fileName into a fresh prerequisite graph, with
+ * an edge from each course to each of its prerequisites, the way testFindAll
+ * does. Every course named, either way, is listed. A line ends a course's
+ * prerequisites whether or not it has a "|". Throws if the file can't be
+ * read or names a course there isn't.
+ ******************************************************************************/
+void readCurriculum(const char * in_fileName, Graph & out_prerequisites,
+                    vector<bool> & out_isListed)
+{
+   ifstream fin(in_fileName);
+   if (!fin.good())
+      throw "ERROR: Unable to open the curriculum file.";
+
+   out_prerequisites = Graph(NUM_CLASS);
+   out_isListed.assign(NUM_CLASS, false);
+
+   string line;
+   string name;
+   while (getline(fin, line))
+   {
+      istringstream words(line);
+      if (!(words >> name) || name == "|")
+         continue;
+      int course = findCourse(name);
+      if (course == -1)
+         throw "ERROR: Unknown course in the curriculum file.";
+      out_isListed[course] = true;
+
+      Vertex vFrom = Vertex::fromIndex(course);
+      while (words >> name && name != "|")
+      {
+         int prerequisite = findCourse(name);
+         if (prerequisite == -1)
+            throw "ERROR: Unknown course in the curriculum file.";
+         out_isListed[prerequisite] = true;
+         Vertex vTo = Vertex::fromIndex(prerequisite);
+         out_prerequisites.add(vFrom, vTo);
+      }
+   }
+}
+
+/******************************************************************************
+ * SCHEDULE COURSES
+ * Each course's earliest semester is one more than the latest of its
+ * prerequisites', which is the number of courses on the longest chain of
+ * prerequisites it starts, so the fewest semesters the curriculum takes,
+ * with no limit on courses a semester, is the longest chain of all: the
+ * critical path. The order is semester by semester. If the prerequisites go
+ * in a circle there is no schedule, just the circle.
+ ******************************************************************************/
+CourseSchedule scheduleCourses(const Graph & in_prerequisites,
+                               const vector<bool> & in_isListed)
+{
+   assert(in_prerequisites.size() == (int)in_isListed.size());
+   CourseSchedule schedule;
+   schedule.error = NULL;
+   schedule.numSemesters = 0;
+
+   vector<Vertex> order;
+   if (!in_prerequisites.topologicalSort(order))
+   {
+      schedule.error = "ERROR: The prerequisites go in a circle.";
+      schedule.cycle = in_prerequisites.findCycle();
+      return schedule;
+   }
+
+   vector<int> lengths;
+   schedule.criticalPath = in_prerequisites.longestPath(lengths);
+   schedule.semesters.assign(in_prerequisites.size(), 0);
+   for (int i = 0; i < in_prerequisites.size(); ++i)
+      if (in_isListed[i])
+      {
+         schedule.semesters[i] = lengths[i];
+         if (lengths[i] > schedule.numSemesters)
+            schedule.numSemesters = lengths[i];
+      }
+
+   // a course that isn't listed has no prerequisites and nothing requires
+   // it, so if the longest path is one of those, every chain is a single
+   // course and any listed one will do
+   if (!schedule.criticalPath.empty() &&
+       !in_isListed[schedule.criticalPath[0].index()])
+   {
+      schedule.criticalPath.clear();
+      for (int i = 0; i < in_prerequisites.size(); ++i)
+         if (in_isListed[i])
+         {
+            schedule.criticalPath.push_back(Vertex::fromIndex(i));
+            break;
+         }
+   }
+   reverse(schedule.criticalPath.begin(), schedule.criticalPath.end());
+
+   // bucket the courses by semester
+   vector<int> firsts(schedule.numSemesters + 2, 0);
+   for (int i = 0; i < in_prerequisites.size(); ++i)
+      firsts[schedule.semesters[i] + 1]++;
+   for (size_t s = 1; s < firsts.size(); ++s)
+      firsts[s] += firsts[s - 1];
+   order.resize(firsts.back());
+   for (int i = 0; i < in_prerequisites.size(); ++i)
+      order[firsts[schedule.semesters[i]]++] = Vertex::fromIndex(i);
+   schedule.order.assign(order.begin() + firsts[0], order.end());
+   return schedule;
+}
+
+/******************************************************************************
+ * SCHEDULE CURRICULA
+ * Reads and schedules each of in_fileNames, a few to a task on in_pool, so
+ * thousands of curricula keep every thread busy. A curriculum that can't be
+ * read gets a schedule with just its error.
+ ******************************************************************************/
+void scheduleCurricula(const vector<string> & in_fileNames,
+                       vector<CourseSchedule> & out_schedules,
+                       ThreadPool & in_pool)
+{
+   courseNames();
+   out_schedules.resize(in_fileNames.size());
+
+   for (size_t first = 0; first < in_fileNames.size();
+        first += CURRICULA_PER_TASK)
+   {
+      size_t last = first + CURRICULA_PER_TASK;
+      if (last > in_fileNames.size())
+         last = in_fileNames.size();
+
+      in_pool.submit([&, first, last](int worker)
+      {
+         Graph prerequisites(NUM_CLASS);
+         vector<bool> isListed;
+         for (size_t i = first; i < last; ++i)
+         {
+            try
+            {
+               readCurriculum(in_fileNames[i].c_str(), prerequisites, isListed);
+               out_schedules[i] = scheduleCourses(prerequisites, isListed);
+            }
+            catch (const char * error)
+            {
+               out_schedules[i] = CourseSchedule();
+               out_schedules[i].error = error;
+               out_schedules[i].numSemesters = 0;
+            }
+         }
+      });
+   }
+   in_pool.wait();
+}
+
+/******************************************************************************
+ * PLAN SEMESTERS
+ * Prompts for the curriculum files, all on one line, and shows each one's
+ * courses semester by semester and its longest chain of prerequisites
+ ******************************************************************************/
+void planSemesters()
+{
+   string line;
+   cout << "What are the filenames? ";
+   getline(cin >> ws, line);
+
+   vector<string> fileNames;
+   istringstream words(line);
+   string fileName;
+   while (words >> fileName)
+      fileNames.push_back(fileName);
+
+   ThreadPool pool;
+   vector<CourseSchedule> schedules;
+   scheduleCurricula(fileNames, schedules, pool);
+
+   const vector<string> & names = courseNames();
+   for (size_t i = 0; i < schedules.size(); ++i)
+   {
+      const CourseSchedule & schedule = schedules[i];
+      cout << fileNames[i] << ": ";
+      if (schedule.error != NULL)
+      {
+         cout << schedule.error << endl;
+         if (!schedule.cycle.empty())
+         {
+            cout << "\tCycle:";
+            for (size_t j = 0; j < schedule.cycle.size(); ++j)
+               cout << ' ' << names[schedule.cycle[j].index()] << " ->";
+            cout << ' ' << names[schedule.cycle[0].index()] << endl;
+         }
+         continue;
+      }
+
+      cout << schedule.numSemesters
+           << (schedule.numSemesters == 1 ? " semester\n" : " semesters\n");
+      size_t j = 0;
+      for (int semester = 1; semester <= schedule.numSemesters; ++semester)
+      {
+         cout << "\tSemester " << semester << ':';
+         for (; j < schedule.order.size() &&
+                schedule.semesters[schedule.order[j].index()] == semester; ++j)
+            cout << ' ' << names[schedule.order[j].index()];
+         cout << endl;
+      }
+      cout << "\tLongest chain:";
+      for (j = 0; j < schedule.criticalPath.size(); ++j)
+         cout << (j ? " -> " : " ") << names[schedule.criticalPath[j].index()];
+      cout << endl;
+   }
+}
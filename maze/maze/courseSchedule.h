@@ -0,0 +1,55 @@
+/***********************************************************************
+* Component:
+*    Week 13, Course Schedule
+* Author:
+*    Matthew Burr
+* Summary:
+*    Orders the courses of a curriculum after their prerequisites and
+*    finds the fewest semesters they take, one curriculum or thousands
+************************************************************************/
+
+#ifndef COURSESCHEDULE_H
+#define COURSESCHEDULE_H
+
+#include "graph.h"
+#include "threadPool.h"
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ * COURSE SCHEDULE
+ * What scheduleCourses() makes of a curriculum. Courses are CourseVertex
+ * indices; only those the curriculum names are scheduled.
+ ******************************************************************************/
+struct CourseSchedule
+{
+   const char * error;               // why there is no schedule, or NULL
+   std::vector<Vertex> order;        // every course after its prerequisites
+   std::vector<int> semesters;       // each course's earliest semester, from
+                                     // 1, by index; 0 if not in it
+   int numSemesters;                 // the fewest that hold every course
+   std::vector<Vertex> criticalPath; // a longest prerequisite chain, first
+                                     // course first
+   std::vector<Vertex> cycle;        // courses that each require the next,
+                                     // and the last the first, if any
+};
+
+// read a curriculum in the format of cs.txt: a line per course, the course
+// and then its prerequisites, ending with an optional "|"
+void readCurriculum(const char * in_fileName, Graph & out_prerequisites,
+                    std::vector<bool> & out_isListed);
+
+// schedule the listed courses of a prerequisite graph, whose edges go from
+// each course to the courses it requires
+CourseSchedule scheduleCourses(const Graph & in_prerequisites,
+                               const std::vector<bool> & in_isListed);
+
+// read and schedule every curriculum on in_pool's threads, in order
+void scheduleCurricula(const std::vector<std::string> & in_fileNames,
+                       std::vector<CourseSchedule> & out_schedules,
+                       ThreadPool & in_pool);
+
+// prompt for curriculum files and show their schedules
+void planSemesters();
+
+#endif // COURSESCHEDULE_H
@@ -0,0 +1,147 @@
+/***********************************************************************
+* Component:
+*    Week 13, Dynamic Paths
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the DynamicShortestPaths class
+************************************************************************/
+
+#include "dynamicPaths.h"
+#include <cassert>
+using namespace std;
+
+/******************************************************************************
+ * DYNAMIC SHORTEST PATHS CONSTRUCTOR
+ * Finds the shortest paths from in_source to everything in a Graph
+ ******************************************************************************/
+DynamicShortestPaths::DynamicShortestPaths(Graph & in_graph,
+                                           const Vertex & in_source)
+   : m_graph(&in_graph), m_grid(NULL), m_source(in_source.index()),
+     m_touched(0)
+{
+   assert(m_source >= 0 && m_source < in_graph.size());
+   searchAll(in_graph);
+}
+
+/******************************************************************************
+ * DYNAMIC SHORTEST PATHS CONSTRUCTOR
+ * Finds the shortest paths from in_source to everything in a GridGraph
+ ******************************************************************************/
+DynamicShortestPaths::DynamicShortestPaths(GridGraph & in_graph,
+                                           const Vertex & in_source)
+   : m_graph(NULL), m_grid(&in_graph), m_source(in_source.index()),
+     m_touched(0)
+{
+   assert(m_source >= 0 && m_source < in_graph.size());
+   searchAll(in_graph);
+}
+
+/******************************************************************************
+ * DYNAMIC SHORTEST PATHS ADD
+ * Adds the edge in_from --> in_to to the graph and repairs the paths it
+ * shortens. A GridGraph passage opens both ways, so both ends are tried.
+ ******************************************************************************/
+void DynamicShortestPaths::add(Vertex & in_from, Vertex & in_to)
+{
+   m_touched = 0;
+   if (m_graph != NULL)
+   {
+      m_graph->add(in_from, in_to);
+      relax(*m_graph, in_from.index(), in_to.index());
+   }
+   else
+   {
+      m_grid->add(in_from, in_to);
+      relax(*m_grid, in_from.index(), in_to.index());
+      relax(*m_grid, in_to.index(), in_from.index());
+   }
+}
+
+/******************************************************************************
+ * DYNAMIC SHORTEST PATHS FIND PATH
+ * The shortest path from the source to in_end, running from in_end back to
+ * the source like Graph::findPath. Throws if there is none.
+ ******************************************************************************/
+vector<Vertex> DynamicShortestPaths::findPath(const Vertex & in_end) const
+{
+   assert(in_end.index() >= 0 && in_end.index() < (int)m_distance.size());
+   if (m_distance[in_end.index()] == -1)
+      throw "ERROR: No path from source to destination.";
+
+   vector<Vertex> path;
+   path.push_back(in_end);
+   for (int v = in_end.index(); v != m_source; v = m_predecessor[v])
+      path.push_back(Vertex::fromIndex(m_predecessor[v]));
+   return path;
+}
+
+/******************************************************************************
+ * DYNAMIC SHORTEST PATHS RELAX
+ * If the edge in_from --> in_to gives in_to a shorter path, takes it and
+ * passes the gain on. Every edge has length one and the search runs
+ * breadth-first from in_to, so vertices are reached in order of their new
+ * distance and each is updated at most once.
+ ******************************************************************************/
+template <class G>
+void DynamicShortestPaths::relax(const G & in_graph, int in_from, int in_to)
+{
+   int distance = m_distance[in_from];
+   if (distance == -1 ||
+       (m_distance[in_to] != -1 && m_distance[in_to] <= distance + 1))
+      return;
+
+   m_distance[in_to] = distance + 1;
+   m_predecessor[in_to] = in_from;
+   m_touched++;
+
+   int head = 0;
+   int tail = 0;
+   m_queue[tail++] = in_to;
+   while (head < tail)
+   {
+      int v = m_queue[head++];
+      int next = m_distance[v] + 1;
+      in_graph.forEachNeighbor(v, [&](int w)
+      {
+         if (m_distance[w] == -1 || m_distance[w] > next)
+         {
+            m_distance[w] = next;
+            m_predecessor[w] = v;
+            m_queue[tail++] = w;
+            m_touched++;
+         }
+      });
+   }
+}
+
+/******************************************************************************
+ * DYNAMIC SHORTEST PATHS SEARCH ALL
+ * The first, full, breadth-first search from the source
+ ******************************************************************************/
+template <class G>
+void DynamicShortestPaths::searchAll(const G & in_graph)
+{
+   m_distance.assign(in_graph.size(), -1);
+   m_predecessor.assign(in_graph.size(), -1);
+   m_queue.assign(in_graph.size(), 0);
+
+   int head = 0;
+   int tail = 0;
+   m_distance[m_source] = 0;
+   m_predecessor[m_source] = m_source;
+   m_queue[tail++] = m_source;
+   while (head < tail)
+   {
+      int v = m_queue[head++];
+      in_graph.forEachNeighbor(v, [&](int w)
+      {
+         if (m_distance[w] == -1)
+         {
+            m_distance[w] = m_distance[v] + 1;
+            m_predecessor[w] = v;
+            m_queue[tail++] = w;
+         }
+      });
+   }
+}
@@ -0,0 +1,62 @@
+/***********************************************************************
+* Component:
+*    Week 13, Dynamic Paths
+* Author:
+*    Matthew Burr
+* Summary:
+*    Shortest paths from one source that are kept up to date as edges
+*    are added, without searching the whole graph again
+************************************************************************/
+
+#ifndef DYNAMICPATHS_H
+#define DYNAMICPATHS_H
+
+#include "graph.h"
+#include "gridGraph.h"
+#include "vertex.h"
+#include <vector>
+
+/******************************************************************************
+ * DYNAMIC SHORTEST PATHS
+ * The distance and predecessor of every vertex on a shortest path from one
+ * source, in a Graph or GridGraph. Edges go in through add(), which adds
+ * them to the graph and then repairs only what they change: an edge can
+ * only make paths shorter, so a search runs outward from its far end and
+ * stops wherever a distance doesn't shrink. Adding an edge that shortens
+ * nothing costs O(1). The graph must not be changed other than through
+ * add() while this is bound to it.
+ ******************************************************************************/
+class DynamicShortestPaths
+{
+public:
+   DynamicShortestPaths(Graph & in_graph, const Vertex & in_source);
+   DynamicShortestPaths(GridGraph & in_graph, const Vertex & in_source);
+
+   void add(Vertex & in_from, Vertex & in_to);
+
+   // the distance from the source, or -1 if in_vertex can't be reached
+   int distance(const Vertex & in_vertex) const
+   {
+      return m_distance[in_vertex.index()];
+   }
+   std::vector<Vertex> findPath(const Vertex & in_end) const;
+
+   // vertices whose distance the last add() shortened
+   int touched() const { return m_touched; }
+
+private:
+   template <class G>
+   void relax(const G & in_graph, int in_from, int in_to);
+   template <class G>
+   void searchAll(const G & in_graph);
+
+   Graph * m_graph;                     // the graph searched: one of these
+   GridGraph * m_grid;                  // two is set, the other is NULL
+   int m_source;
+   std::vector<int> m_distance;         // -1 where there is no path yet
+   std::vector<VertexId> m_predecessor;
+   std::vector<VertexId> m_queue;       // reused by every repair
+   int m_touched;
+};
+
+#endif // DYNAMICPATHS_H
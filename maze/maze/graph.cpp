@@ -8,8 +8,11 @@
 ************************************************************************/
 
 #include "graph.h"
+#include "mappedFile.h"
 #include <vector>
 #include <queue>
+#include <algorithm>
+#include <new>
 using namespace std;
 
 /******************************************************************************
@@ -17,10 +20,104 @@ using namespace std;
  * Creates a new instance of Graph that contains in_size vertices
  ******************************************************************************/
 Graph::Graph(int in_size)
-   : m_size(in_size), m_adjList(NULL)
+   : m_size(in_size), m_numCol(in_size), m_numRow(1),
+     m_adjList(NULL), m_arena(NULL), m_offsets(NULL), m_neighbors(NULL),
+     m_revOffsets(NULL), m_revNeighbors(NULL), m_file(NULL),
+     m_pathCache(NULL)
 {
    assert(m_size > 0);
-   m_adjList = new VertexSet[m_size];
+   allocateAdjList();
+   assert(isValidGraph(*this));
+}
+
+/******************************************************************************
+* GRAPH CONSTRUCTOR
+* Creates a new instance of Graph for a maze of in_numCol by in_numRow cells
+******************************************************************************/
+Graph::Graph(int in_numCol, int in_numRow)
+   : m_size(in_numCol * in_numRow), m_numCol(in_numCol), m_numRow(in_numRow),
+     m_adjList(NULL), m_arena(NULL), m_offsets(NULL), m_neighbors(NULL),
+     m_revOffsets(NULL), m_revNeighbors(NULL), m_file(NULL),
+     m_pathCache(NULL)
+{
+   assert(m_numCol > 0 && m_numRow > 0);
+   allocateAdjList();
+   assert(isValidGraph(*this));
+}
+
+/******************************************************************************
+* GRAPH CONSTRUCTOR
+* Creates a frozen Graph for a maze of in_numCol by in_numRow cells whose
+* compressed sparse row arrays live in in_file, which the Graph takes
+* ownership of. The arrays are used where they are, not copied.
+******************************************************************************/
+Graph::Graph(int in_numCol, int in_numRow, const CsrArrays & in_arrays,
+             MappedFile * in_file)
+   : m_size(in_numCol * in_numRow), m_numCol(in_numCol), m_numRow(in_numRow),
+     m_adjList(NULL), m_arena(NULL),
+     m_offsets(in_arrays.offsets), m_neighbors(in_arrays.neighbors),
+     m_revOffsets(in_arrays.revOffsets), m_revNeighbors(in_arrays.revNeighbors),
+     m_file(in_file), m_pathCache(NULL)
+{
+   assert(m_file != NULL);
+   assert(isValidGraph(*this));
+}
+
+/******************************************************************************
+* GRAPH CONSTRUCTOR
+* Creates a frozen Graph for a maze of in_numCol by in_numRow cells holding
+* every edge in in_edges, which may come in any order and may repeat. The
+* edges are counting-sorted by source straight into the CSR arrays, so no
+* per-vertex edge sets are ever built.
+******************************************************************************/
+Graph::Graph(int in_numCol, int in_numRow, const vector<Edge> & in_edges)
+   : m_size(in_numCol * in_numRow), m_numCol(in_numCol), m_numRow(in_numRow),
+     m_adjList(NULL), m_arena(NULL), m_offsets(NULL), m_neighbors(NULL),
+     m_revOffsets(NULL), m_revNeighbors(NULL), m_file(NULL),
+     m_pathCache(NULL)
+{
+   assert(m_numCol > 0 && m_numRow > 0);
+   int numEdges = (int)in_edges.size();
+
+   // count the edges from each vertex, then turn the counts into offsets
+   int * offsets = new int[m_size + 1];
+   for (int i = 0; i <= m_size; ++i)
+      offsets[i] = 0;
+   for (int i = 0; i < numEdges; ++i)
+   {
+      assert(in_edges[i].from >= 0 && in_edges[i].from < m_size);
+      assert(in_edges[i].to >= 0 && in_edges[i].to < m_size);
+      offsets[in_edges[i].from + 1]++;
+   }
+   for (int i = 0; i < m_size; ++i)
+      offsets[i + 1] += offsets[i];
+
+   int * neighbors = new int[numEdges > 0 ? numEdges : 1];
+   int * fill = new int[m_size];
+   for (int i = 0; i < m_size; ++i)
+      fill[i] = offsets[i];
+   for (int i = 0; i < numEdges; ++i)
+      neighbors[fill[in_edges[i].from]++] = in_edges[i].to;
+   delete[] fill;
+
+   // sort each vertex's neighbors and squeeze out repeated edges
+   int next = 0;
+   for (int i = 0; i < m_size; ++i)
+   {
+      int begin = offsets[i];
+      int end = offsets[i + 1];
+      sort(neighbors + begin, neighbors + end);
+      offsets[i] = next;
+      for (int j = begin; j < end; ++j)
+         if (j == begin || neighbors[j] != neighbors[j - 1])
+            neighbors[next++] = neighbors[j];
+   }
+   offsets[m_size] = next;
+
+   m_offsets = offsets;
+   m_neighbors = neighbors;
+   buildReverse();
+
    assert(isValidGraph(*this));
 }
 
@@ -29,11 +126,28 @@ Graph::Graph(int in_size)
 * Creates a new instance of Graph that is a copy of an existing instance
 ******************************************************************************/
 Graph::Graph(const Graph & in_source)
-   : m_size(0), m_adjList(NULL)
+   : m_size(0), m_numCol(0), m_numRow(0),
+     m_adjList(NULL), m_arena(NULL), m_offsets(NULL), m_neighbors(NULL),
+     m_revOffsets(NULL), m_revNeighbors(NULL), m_file(NULL),
+     m_pathCache(NULL)
 {
    clone(in_source);
 }
 
+/******************************************************************************
+* GRAPH MOVE CONSTRUCTOR
+* Creates a new instance of Graph that takes over the storage of one that is
+* about to go away
+******************************************************************************/
+Graph::Graph(Graph && in_source)
+   : m_size(0), m_numCol(0), m_numRow(0),
+     m_adjList(NULL), m_arena(NULL), m_offsets(NULL), m_neighbors(NULL),
+     m_revOffsets(NULL), m_revNeighbors(NULL), m_file(NULL),
+     m_pathCache(NULL)
+{
+   take(in_source);
+}
+
 /******************************************************************************
 * GRAPH DESTRUCTOR
 * Destroys a graph
@@ -45,12 +159,17 @@ Graph::~Graph()
 
 /******************************************************************************
 * GRAPH ADD
-* Adds a new edge from in_from to in_to to the Graph
+* Adds a new edge from in_from to in_to to the Graph. A frozen Graph is
+* thawed back into edge sets first.
 ******************************************************************************/
 void Graph::add(Vertex & in_from, Vertex & in_to)
 {
    assert(in_from.index() >= 0 && in_from.index() < size());
-   m_adjList[in_from.index()].insert(in_to);
+   if (isFrozen())
+      thaw();
+   m_adjList[in_from.index()].insert(in_to.index());
+   if (m_pathCache != NULL)
+      m_pathCache->clear();
 }
 
 /******************************************************************************
@@ -63,6 +182,68 @@ void Graph::add(Vertex & in_from, VertexSet & in_to)
       add(in_from, *it);
 }
 
+/******************************************************************************
+* GRAPH REMOVE
+* Removes the edge from in_from to in_to, if there is one. A frozen Graph is
+* thawed back into edge sets first, as for add.
+******************************************************************************/
+void Graph::remove(Vertex & in_from, Vertex & in_to)
+{
+   assert(vertexIsInBounds(in_from));
+   if (isFrozen())
+      thaw();
+
+   VertexId to = in_to.index();
+   SetIterator<VertexId> it = m_adjList[in_from.index()].find(to);
+   if (it != m_adjList[in_from.index()].end())
+      m_adjList[in_from.index()].erase(it);
+   if (m_pathCache != NULL)
+      m_pathCache->clear();
+}
+
+/******************************************************************************
+* GRAPH CLEAR
+* Removes every edge, keeping the vertices. Whatever held the edges, edge
+* sets or CSR arrays, is freed whole and replaced by empty edge sets, so
+* this costs O(V) however many edges there were.
+******************************************************************************/
+void Graph::clear()
+{
+   releaseAdjList();
+   releaseCsr();
+   allocateAdjList();
+   if (m_pathCache != NULL)
+      m_pathCache->clear();
+
+   assert(isValidGraph(*this));
+}
+
+/******************************************************************************
+* GRAPH RESERVE
+* Sets aside room in one block for in_numEdges edges before they are added,
+* so their buffers are laid out together. Buffers the edge sets outgrow are
+* recycled by the arena; anything beyond the reservation takes more chunks.
+* Only matters while the Graph is being built.
+******************************************************************************/
+void Graph::reserve(int in_numEdges)
+{
+   if (!isFrozen())
+      m_arena->reserve((size_t)in_numEdges * sizeof(VertexId));
+}
+
+/******************************************************************************
+* GRAPH ALLOCATION STATS
+* What the arena behind the edge sets has done. A frozen Graph has no edge
+* sets, and so reports nothing.
+******************************************************************************/
+ArenaStats Graph::allocationStats() const
+{
+   if (m_arena != NULL)
+      return m_arena->stats();
+   ArenaStats none = { 0, 0, 0, 0 };
+   return none;
+}
+
 /******************************************************************************
 * GRAPH IS EDGE
 * Returns true if there is an edge from in_from to in_to in the Graph
@@ -70,9 +251,27 @@ void Graph::add(Vertex & in_from, VertexSet & in_to)
 bool Graph::isEdge(const Vertex & in_from, Vertex & in_to) const
 {
    assert(vertexIsInBounds(in_from));
-   return m_adjList[in_from.index()].find(in_to) != 
-      m_adjList[in_from.index()].end();
+   if (!isFrozen())
+   {
+      VertexId to = in_to.index();
+      return m_adjList[in_from.index()].find(to) !=
+         m_adjList[in_from.index()].end();
+   }
 
+   // the neighbors of each vertex are sorted, so binary search them
+   int begin = m_offsets[in_from.index()];
+   int end = m_offsets[in_from.index() + 1] - 1;
+   while (begin <= end)
+   {
+      int middle = (begin + end) / 2;
+      if (m_neighbors[middle] == in_to.index())
+         return true;
+      if (m_neighbors[middle] < in_to.index())
+         begin = middle + 1;
+      else
+         end = middle - 1;
+   }
+   return false;
 }
 
 /******************************************************************************
@@ -82,7 +281,32 @@ bool Graph::isEdge(const Vertex & in_from, Vertex & in_to) const
 VertexSet Graph::findEdges(const Vertex & in_from) const
 {
    assert(vertexIsInBounds(in_from));
-   return m_adjList[in_from.index()];
+
+   NeighborRange range = neighbors(in_from);
+   VertexSet edges(range.size());
+   for (NeighborIterator it = range.begin(); it != range.end(); ++it)
+      edges.insert(Vertex::fromIndex(*it));
+   return edges;
+}
+
+/******************************************************************************
+* GRAPH NEIGHBORS
+* Returns a view of the vertices that have an edge from in_from in the Graph.
+* Nothing is copied; the view is invalidated by the next change to the Graph.
+******************************************************************************/
+NeighborRange Graph::neighbors(const Vertex & in_from) const
+{
+   assert(vertexIsInBounds(in_from));
+   int from = in_from.index();
+
+   if (isFrozen())
+      return NeighborRange(m_neighbors + m_offsets[from],
+                           m_neighbors + m_offsets[from + 1],
+                           m_offsets[from + 1] - m_offsets[from]);
+
+   const VertexId * p = m_adjList[from].data();
+   int count = m_adjList[from].size();
+   return NeighborRange(p, p + count, count);
 }
 
 /******************************************************************************
@@ -91,71 +315,405 @@ VertexSet Graph::findEdges(const Vertex & in_from) const
 ******************************************************************************/
 Graph & Graph::operator=(const Graph & in_source)
 {
+   if (this == &in_source)
+      return *this;
    destroy();
    clone(in_source);
    return *this;
 }
 
+/******************************************************************************
+* GRAPH MOVE ASSIGNMENT OPERATOR
+* Sets this instance of Graph to take over the storage of in_source, which
+* is about to go away
+******************************************************************************/
+Graph & Graph::operator=(Graph && in_source)
+{
+   if (this == &in_source)
+      return *this;
+   destroy();
+   take(in_source);
+   return *this;
+}
+
 /******************************************************************************
 * GRAPH FIND PATH
 * Finds the shortest path from the first Vertex in the Graph to the last
 ******************************************************************************/
 vector<Vertex> Graph::findPath() const
 {
-   return findPath(Vertex(0), Vertex(size() - 1));
+   return findPath(Vertex::fromIndex(0), Vertex::fromIndex(size() - 1));
 }
 
 /******************************************************************************
 * GRAPH FIND PATH
-* Finds the shortest path from in_start to in_end in the Graph
-* Uses the algorithm proposed by Bro. Helfrich in his text
+* Finds the shortest path from in_start to in_end in the Graph. A path from
+* a vertex to itself is just that vertex, in every mode.
 ******************************************************************************/
 vector<Vertex> Graph::findPath(const Vertex & in_start, const Vertex & in_end) const
 {
+   if (m_pathCache != NULL)
+      return findPathCached(in_start, in_end);
+
+   int expanded = 0;
+   return findPathForward(in_start, in_end, expanded);
+}
+
+/******************************************************************************
+* GRAPH FIND PATH
+* Finds the shortest path from in_start to in_end in the Graph using the
+* given search mode. The path runs from in_end back to in_start, and
+* out_expanded receives the number of vertices the search expanded.
+* A bidirectional search needs the reverse edges that freeze() builds, so
+* on a Graph that isn't frozen it falls back to a forward search. Either
+* way, a path from a vertex to itself is just that vertex.
+******************************************************************************/
+vector<Vertex> Graph::findPath(const Vertex & in_start, const Vertex & in_end,
+                               SearchMode in_mode, int & out_expanded) const
+{
+   if (in_mode == SEARCH_BIDIRECTIONAL && isFrozen())
+      return findPathBidirectional(in_start, in_end, out_expanded);
+   return findPathForward(in_start, in_end, out_expanded);
+}
+
+/******************************************************************************
+* GRAPH DISTANCES FROM
+* Returns the number of edges on the shortest path from in_source to every
+* vertex in the Graph, or -1 for a vertex that can't be reached
+******************************************************************************/
+vector<int> Graph::distancesFrom(const Vertex & in_source) const
+{
+   vector<int> distances;
+   vector<VertexId> queue;
+   distancesFrom(in_source, distances, queue);
+   return distances;
+}
+
+/******************************************************************************
+* GRAPH DISTANCES FROM
+* Fills out_distances with the distance from in_source to every vertex, as
+* above. One breadth-first search covers the whole Graph; the queue is a
+* single array, since each vertex enters it once. Both out_distances and
+* io_queue are scratch the caller keeps, so repeated calls reuse their
+* storage rather than allocating V ints apiece.
+******************************************************************************/
+void Graph::distancesFrom(const Vertex & in_source,
+                          vector<int> & out_distances,
+                          vector<VertexId> & io_queue) const
+{
+   assert(vertexIsInBounds(in_source));
+
+   out_distances.assign(size(), -1);
+   if ((int)io_queue.size() < size())
+      io_queue.resize(size());
+   VertexId * queue = io_queue.data();
+   int head = 0;
+   int tail = 0;
+   queue[tail++] = in_source.index();
+   out_distances[in_source.index()] = 0;
+
+   while (head < tail)
+   {
+      VertexId v = queue[head++];
+      int distance = out_distances[v] + 1;
+      forEachNeighbor(v, [&](int index)
+      {
+         if (out_distances[index] == -1)
+         {
+            out_distances[index] = distance;
+            queue[tail++] = index;
+         }
+      });
+   }
+}
+
+/******************************************************************************
+* GRAPH TOPOLOGICAL SORT
+* Fills out_order with every vertex, each one before all the vertices it has
+* edges to, by Kahn's algorithm: count the edges into each vertex, then
+* take the vertices with none left, dropping their edges as they go. The
+* order doubles as the queue, so it is O(V + E) with no other storage but
+* the counts. Returns false if the edges go round in a circle, leaving
+* out_order with just the vertices that could be placed; findCycle() then
+* says where the circle is.
+******************************************************************************/
+bool Graph::topologicalSort(vector<Vertex> & out_order) const
+{
+   vector<int> numIn(size(), 0);
+   for (int v = 0; v < size(); ++v)
+      forEachNeighbor(v, [&](int index)
+      {
+         numIn[index]++;
+      });
+
+   out_order.clear();
+   out_order.reserve(size());
+   for (int v = 0; v < size(); ++v)
+      if (numIn[v] == 0)
+         out_order.push_back(Vertex::fromIndex(v));
+
+   for (size_t head = 0; head < out_order.size(); ++head)
+      forEachNeighbor(out_order[head].index(), [&](int index)
+      {
+         if (--numIn[index] == 0)
+            out_order.push_back(Vertex::fromIndex(index));
+      });
+
+   return (int)out_order.size() == size();
+}
+
+/******************************************************************************
+* GRAPH FIND CYCLE
+* Returns the vertices of one circle of edges, each with an edge to the
+* next and the last with an edge back to the first, or nothing if there is
+* none. A depth-first search, kept on a stack of its own rather than the
+* call stack, finds one as soon as an edge leads back to a vertex still
+* on the stack.
+******************************************************************************/
+vector<Vertex> Graph::findCycle() const
+{
+   // 0 if not yet seen, 1 while on the stack, 2 once finished
+   vector<char> state(size(), 0);
+   vector<int> stack;
+   vector<int> nextEdge;         // the next neighbor of each vertex on it
+   vector<Vertex> cycle;
+
+   for (int root = 0; root < size(); ++root)
+   {
+      if (state[root] != 0)
+         continue;
+      state[root] = 1;
+      stack.push_back(root);
+      nextEdge.push_back(0);
+
+      while (!stack.empty())
+      {
+         int v = stack.back();
+         NeighborRange range = neighbors(Vertex::fromIndex(v));
+         if (nextEdge.back() == range.size())
+         {
+            state[v] = 2;
+            stack.pop_back();
+            nextEdge.pop_back();
+            continue;
+         }
+
+         int w = range.begin()[nextEdge.back()++];
+         if (state[w] == 0)
+         {
+            state[w] = 1;
+            stack.push_back(w);
+            nextEdge.push_back(0);
+         }
+         else if (state[w] == 1)
+         {
+            size_t first = stack.size() - 1;
+            while (stack[first] != w)
+               first--;
+            for (size_t i = first; i < stack.size(); ++i)
+               cycle.push_back(Vertex::fromIndex(stack[i]));
+            return cycle;
+         }
+      }
+   }
+   return cycle;
+}
+
+/******************************************************************************
+* GRAPH LONGEST PATH
+* The critical path of a graph with no cycles: a path through the most
+* vertices, running along the edges from its first vertex to its last.
+* out_lengths gets, for every vertex, the number of vertices on the longest
+* path starting there, worked out in reverse topological order so each
+* vertex's neighbors are done before it. Throws if there is a cycle.
+******************************************************************************/
+vector<Vertex> Graph::longestPath(vector<int> & out_lengths) const
+{
+   vector<Vertex> order;
+   if (!topologicalSort(order))
+      throw "ERROR: The graph has a cycle.";
+
+   out_lengths.assign(size(), 1);
+   int longest = -1;
+   for (int i = size() - 1; i >= 0; --i)
+   {
+      int v = order[i].index();
+      forEachNeighbor(v, [&](int index)
+      {
+         if (out_lengths[index] + 1 > out_lengths[v])
+            out_lengths[v] = out_lengths[index] + 1;
+      });
+      if (longest == -1 || out_lengths[v] > out_lengths[longest])
+         longest = v;
+   }
+
+   // follow the neighbors one shorter
+   vector<Vertex> path;
+   for (int v = longest; v != -1; )
+   {
+      path.push_back(Vertex::fromIndex(v));
+      int next = -1;
+      forEachNeighbor(v, [&](int index)
+      {
+         if (next == -1 && out_lengths[index] == out_lengths[v] - 1)
+            next = index;
+      });
+      v = next;
+   }
+   return path;
+}
+
+/******************************************************************************
+* GRAPH ENABLE PATH CACHE
+* Has findPath keep the search trees of recent starts, taking up to
+* in_budgetBytes; each tree takes size() * sizeof(VertexId) bytes
+******************************************************************************/
+void Graph::enablePathCache(size_t in_budgetBytes)
+{
+   delete m_pathCache;
+   m_pathCache = new PathCache(in_budgetBytes);
+}
+
+/******************************************************************************
+* GRAPH DISABLE PATH CACHE
+* Drops the path cache and every tree in it
+******************************************************************************/
+void Graph::disablePathCache()
+{
+   delete m_pathCache;
+   m_pathCache = NULL;
+}
+
+/******************************************************************************
+* GRAPH PATH CACHE STATS
+* How the path cache has done; all zeros if it isn't enabled
+******************************************************************************/
+PathCacheStats Graph::pathCacheStats() const
+{
+   if (m_pathCache != NULL)
+      return m_pathCache->stats();
+   PathCacheStats none = { 0, 0, 0, 0, 0 };
+   return none;
+}
+
+/******************************************************************************
+* GRAPH FIND PATH CACHED
+* Finds the shortest path from in_start to in_end by walking the search
+* tree from in_start, first searching the whole Graph to build the tree if
+* it isn't cached. The search visits vertices in the same order as
+* findPathForward, so the path is the same one it would find.
+******************************************************************************/
+vector<Vertex> Graph::findPathCached(const Vertex & in_start,
+                                     const Vertex & in_end) const
+{
+   assert(m_pathCache != NULL);
    assert(vertexIsInBounds(in_start));
    assert(vertexIsInBounds(in_end));
 
+   PredecessorTreePtr tree = m_pathCache->find(in_start.index());
+   if (!tree)
+   {
+      PredecessorTree * built = new PredecessorTree(size(), -1);
+      PredecessorTree & predecessor = *built;
+      vector<VertexId> queue(size());
+      int head = 0;
+      int tail = 0;
+      queue[tail++] = in_start.index();
+      predecessor[in_start.index()] = in_start.index();
+      while (head < tail)
+      {
+         VertexId v = queue[head++];
+         forEachNeighbor(v, [&](int index)
+         {
+            if (predecessor[index] == -1)
+            {
+               predecessor[index] = v;
+               queue[tail++] = index;
+            }
+         });
+      }
+      tree = PredecessorTreePtr(built);
+      m_pathCache->insert(in_start.index(), tree);
+   }
+
+   const PredecessorTree & predecessor = *tree;
+   if (predecessor[in_end.index()] == -1)
+      throw "ERROR: No path from source to destination.";
+
+   vector<Vertex> path;
+   path.push_back(in_end);
+   for (int v = in_end.index(); v != in_start.index(); v = predecessor[v])
+      path.push_back(Vertex::fromIndex(predecessor[v]));
+   return path;
+}
+
+/******************************************************************************
+* GRAPH FIND PATH FORWARD
+* Breadth-first search from in_start until in_end is reached
+* Uses the algorithm proposed by Bro. Helfrich in his text
+******************************************************************************/
+vector<Vertex> Graph::findPathForward(const Vertex & in_start,
+                                      const Vertex & in_end,
+                                      int & out_expanded) const
+{
+   assert(vertexIsInBounds(in_start));
+   assert(vertexIsInBounds(in_end));
+
+   out_expanded = 0;
+
+   // the search never marks in_start as reached, so on its own it would
+   // look for a way back around to it; the bidirectional and cached
+   // searches answer with just the vertex, and so does this
+   if (in_start == in_end)
+   {
+      vector<Vertex> path;
+      path.push_back(in_end);
+      return path;
+   }
+
    int distance = 0;
-   queue<Vertex> toVisit;
-   toVisit.push(in_start);
+   queue<VertexId> toVisit;
+   toVisit.push(in_start.index());
    
-   Vertex* predecessor = new Vertex[size()];
+   VertexId* predecessor = new VertexId[size()];
    int* distances = new int[size()];
    for (int i = 0; i < size(); ++i)
       distances[i] = -1;
 
    while (!toVisit.empty() && distances[in_end.index()] == -1)
    {
-      Vertex v = toVisit.front();
+      VertexId v = toVisit.front();
       toVisit.pop();
+      out_expanded++;
 
-      if (distances[v.index()] > distance)
+      if (distances[v] > distance)
          distance++;
 
-      VertexSet s = findEdges(v);
-      for (VertexSetIterator it = s.begin(); it != s.end(); ++it)
+      forEachNeighbor(v, [&](int index)
       {
-         int index = (*it).index();
-
          if (distances[index] == -1)
          {
             distances[index] = distance + 1;
             predecessor[index] = v;
-            toVisit.push(*it);
+            toVisit.push(index);
          }
-      }
+      });
    }
    distance++;
 
    if (distances[in_end.index()] == -1)
+   {
+      delete[] predecessor;
+      delete[] distances;
       throw "ERROR: No path from source to destination.";
+   }
 
    vector<Vertex> path;
    path.push_back(in_end);
 
    for (int i = 1; i <= distance; ++i)
    {
-      path.push_back(predecessor[path[i - 1].index()]);
+      path.push_back(Vertex::fromIndex(predecessor[path[i - 1].index()]));
    }
 
    delete[] predecessor;
@@ -164,21 +722,287 @@ vector<Vertex> Graph::findPath(const Vertex & in_start, const Vertex & in_end) c
 }
 
 /******************************************************************************
-* GRAPH IS VALID GRAPH
-* Checks to ensure that the structure of the Graph looks valid
+* GRAPH FIND PATH BIDIRECTIONAL
+* Breadth-first search from in_start along edges and from in_end against
+* them, one whole level at a time, always growing the smaller frontier.
+* Once a level links the two searches, the shortest link found in that
+* level gives the shortest path.
 ******************************************************************************/
-bool Graph::isValidGraph(const Graph & in_graph) const
+vector<Vertex> Graph::findPathBidirectional(const Vertex & in_start,
+                                            const Vertex & in_end,
+                                            int & out_expanded) const
 {
-   return in_graph.m_size > 0;
+   assert(isFrozen());
+   assert(vertexIsInBounds(in_start));
+   assert(vertexIsInBounds(in_end));
+
+   out_expanded = 0;
+   vector<Vertex> path;
+   if (in_start == in_end)
+   {
+      path.push_back(in_end);
+      return path;
+   }
+
+   // forward distances and predecessors from the start, and backward
+   // distances and successors toward the end
+   vector<int> distForward(size(), -1);
+   vector<int> distBackward(size(), -1);
+   vector<VertexId> predecessor(size(), -1);
+   vector<VertexId> successor(size(), -1);
+   distForward[in_start.index()] = 0;
+   distBackward[in_end.index()] = 0;
+
+   vector<VertexId> frontForward(1, in_start.index());
+   vector<VertexId> frontBackward(1, in_end.index());
+   vector<VertexId> next;
+
+   int best = -1;      // length of the shortest link found so far
+   int meetFrom = -1;  // that link is the edge meetFrom --> meetTo
+   int meetTo = -1;
+
+   while (best == -1 && !frontForward.empty() && !frontBackward.empty())
+   {
+      next.clear();
+      if (frontForward.size() <= frontBackward.size())
+      {
+         for (size_t i = 0; i < frontForward.size(); ++i)
+         {
+            int v = frontForward[i];
+            out_expanded++;
+            for (int j = m_offsets[v]; j < m_offsets[v + 1]; ++j)
+            {
+               int w = m_neighbors[j];
+               if (distBackward[w] != -1)
+               {
+                  int length = distForward[v] + 1 + distBackward[w];
+                  if (best == -1 || length < best)
+                  {
+                     best = length;
+                     meetFrom = v;
+                     meetTo = w;
+                  }
+               }
+               if (distForward[w] == -1)
+               {
+                  distForward[w] = distForward[v] + 1;
+                  predecessor[w] = v;
+                  next.push_back(w);
+               }
+            }
+         }
+         frontForward.swap(next);
+      }
+      else
+      {
+         for (size_t i = 0; i < frontBackward.size(); ++i)
+         {
+            int v = frontBackward[i];
+            out_expanded++;
+            for (int j = m_revOffsets[v]; j < m_revOffsets[v + 1]; ++j)
+            {
+               int w = m_revNeighbors[j];
+               if (distForward[w] != -1)
+               {
+                  int length = distForward[w] + 1 + distBackward[v];
+                  if (best == -1 || length < best)
+                  {
+                     best = length;
+                     meetFrom = w;
+                     meetTo = v;
+                  }
+               }
+               if (distBackward[w] == -1)
+               {
+                  distBackward[w] = distBackward[v] + 1;
+                  successor[w] = v;
+                  next.push_back(w);
+               }
+            }
+         }
+         frontBackward.swap(next);
+      }
+   }
+
+   if (best == -1)
+      throw "ERROR: No path from source to destination.";
+
+   // from the end back to the link, then from the link back to the start
+   vector<int> tail;
+   for (int v = meetTo; v != -1; v = successor[v])
+      tail.push_back(v);
+   for (int i = (int)tail.size() - 1; i >= 0; --i)
+      path.push_back(Vertex::fromIndex(tail[i]));
+   for (int v = meetFrom; v != -1; v = predecessor[v])
+      path.push_back(Vertex::fromIndex(v));
+
+   assert((int)path.size() == best + 1);
+   return path;
 }
 
 /******************************************************************************
-* GRAPH VERTEX IS IN BOUNDS
-* Returns true if the vertex fits within the bounds of the Graph
+* GRAPH FREEZE
+* Packs the per-vertex edge sets into compressed sparse row form: m_offsets
+* holds where each vertex's neighbors start in m_neighbors, and m_neighbors
+* holds every neighbor index back to back. The edge sets are then released.
 ******************************************************************************/
-inline bool Graph::vertexIsInBounds(const Vertex & in_vertex) const
+void Graph::freeze()
 {
-   return in_vertex.index() >= 0 && in_vertex.index() < size();
+   if (isFrozen())
+      return;
+
+   int numEdges = 0;
+   for (int i = 0; i < m_size; ++i)
+      numEdges += m_adjList[i].size();
+
+   int * offsets = new int[m_size + 1];
+   int * neighbors = new int[numEdges > 0 ? numEdges : 1];
+
+   int next = 0;
+   for (int i = 0; i < m_size; ++i)
+   {
+      offsets[i] = next;
+      const VertexId * p = m_adjList[i].data();
+      for (int j = 0; j < m_adjList[i].size(); ++j)
+         neighbors[next++] = p[j];
+   }
+   offsets[m_size] = next;
+
+   releaseAdjList();
+   m_offsets = offsets;
+   m_neighbors = neighbors;
+   buildReverse();
+
+   assert(isValidGraph(*this));
+}
+
+/******************************************************************************
+* GRAPH BUILD REVERSE
+* Builds the reverse CSR arrays from the forward ones
+******************************************************************************/
+void Graph::buildReverse()
+{
+   assert(m_offsets != NULL && m_revOffsets == NULL);
+   int numEdges = m_offsets[m_size];
+
+   // the reverse arrays list, for every vertex, the vertices with an edge
+   // to it. Sources are visited in order, so each list comes out sorted.
+   int * revOffsets = new int[m_size + 1];
+   int * revNeighbors = new int[numEdges > 0 ? numEdges : 1];
+   for (int i = 0; i <= m_size; ++i)
+      revOffsets[i] = 0;
+   for (int i = 0; i < numEdges; ++i)
+      revOffsets[m_neighbors[i] + 1]++;
+   for (int i = 0; i < m_size; ++i)
+      revOffsets[i + 1] += revOffsets[i];
+
+   int * fill = new int[m_size];
+   for (int i = 0; i < m_size; ++i)
+      fill[i] = revOffsets[i];
+   for (int i = 0; i < m_size; ++i)
+      for (int j = m_offsets[i]; j < m_offsets[i + 1]; ++j)
+         revNeighbors[fill[m_neighbors[j]]++] = i;
+   delete[] fill;
+
+   m_revOffsets = revOffsets;
+   m_revNeighbors = revNeighbors;
+}
+
+/******************************************************************************
+* GRAPH CSR
+* Returns the compressed sparse row arrays of a frozen Graph
+******************************************************************************/
+CsrArrays Graph::csr() const
+{
+   assert(isFrozen());
+   CsrArrays arrays;
+   arrays.offsets = m_offsets;
+   arrays.neighbors = m_neighbors;
+   arrays.revOffsets = m_revOffsets;
+   arrays.revNeighbors = m_revNeighbors;
+   return arrays;
+}
+
+/******************************************************************************
+* GRAPH THAW
+* Unpacks the compressed sparse row form back into per-vertex edge sets so
+* that the Graph can be modified again
+******************************************************************************/
+void Graph::thaw()
+{
+   assert(isFrozen());
+
+   allocateAdjList();
+   m_arena->reserve(m_offsets[m_size] * sizeof(VertexId));
+   for (int i = 0; i < m_size; ++i)
+      m_adjList[i].assign(m_neighbors + m_offsets[i],
+                          m_neighbors + m_offsets[i + 1]);
+
+   releaseCsr();
+
+   assert(isValidGraph(*this));
+}
+
+/******************************************************************************
+* GRAPH RELEASE CSR
+* Frees the compressed sparse row arrays, or lets go of the file they were
+* borrowed from
+******************************************************************************/
+void Graph::releaseCsr()
+{
+   if (m_file != NULL)
+      delete m_file;
+   else
+   {
+      delete[] m_offsets;
+      delete[] m_neighbors;
+      delete[] m_revOffsets;
+      delete[] m_revNeighbors;
+   }
+   m_file = NULL;
+   m_offsets = NULL;
+   m_neighbors = NULL;
+   m_revOffsets = NULL;
+   m_revNeighbors = NULL;
+}
+
+/******************************************************************************
+* GRAPH ALLOCATE ADJ LIST
+* Creates an empty edge set for every vertex. The sets, and every buffer
+* they grow into, come from a new Arena rather than one heap allocation
+* apiece.
+******************************************************************************/
+void Graph::allocateAdjList()
+{
+   assert(m_adjList == NULL && m_arena == NULL);
+   m_arena = new Arena;
+   m_adjList = static_cast<VertexIdSet *>(
+      m_arena->allocate(m_size * sizeof(VertexIdSet), alignof(VertexIdSet)));
+   for (int i = 0; i < m_size; ++i)
+      new (m_adjList + i) VertexIdSet(0, m_arena);
+}
+
+/******************************************************************************
+* GRAPH RELEASE ADJ LIST
+* Frees the edge sets by freeing their arena. The sets' destructors would
+* only give their buffers back to that same arena, so they are not run.
+******************************************************************************/
+void Graph::releaseAdjList()
+{
+   delete m_arena;
+   m_arena = NULL;
+   m_adjList = NULL;
+}
+
+/******************************************************************************
+* GRAPH IS VALID GRAPH
+* Checks to ensure that the structure of the Graph looks valid
+******************************************************************************/
+bool Graph::isValidGraph(const Graph & in_graph) const
+{
+   return in_graph.m_size > 0 &&
+      in_graph.m_numCol * in_graph.m_numRow == in_graph.m_size &&
+      (in_graph.m_adjList == NULL) != (in_graph.m_offsets == NULL);
 }
 
 /******************************************************************************
@@ -187,20 +1011,83 @@ inline bool Graph::vertexIsInBounds(const Vertex & in_vertex) const
 ******************************************************************************/
 void Graph::clone(const Graph & in_source)
 {
+   // the copy gets a cache of its own, empty, with the same budget
+   if (in_source.m_pathCache != NULL)
+      m_pathCache = new PathCache(in_source.m_pathCache->budget());
+
    m_size = in_source.m_size;
-   m_adjList = new VertexSet[m_size];
-   for (int i = 0; i < m_size; ++i)
-      m_adjList[i] = in_source.m_adjList[i];
-   
+   m_numCol = in_source.m_numCol;
+   m_numRow = in_source.m_numRow;
+   if (in_source.isFrozen())
+   {
+      // even if the source borrows its arrays, the copy owns its own
+      int numEdges = in_source.m_offsets[m_size];
+      int * offsets = new int[m_size + 1];
+      int * neighbors = new int[numEdges > 0 ? numEdges : 1];
+      int * revOffsets = new int[m_size + 1];
+      int * revNeighbors = new int[numEdges > 0 ? numEdges : 1];
+      for (int i = 0; i <= m_size; ++i)
+      {
+         offsets[i] = in_source.m_offsets[i];
+         revOffsets[i] = in_source.m_revOffsets[i];
+      }
+      for (int i = 0; i < numEdges; ++i)
+      {
+         neighbors[i] = in_source.m_neighbors[i];
+         revNeighbors[i] = in_source.m_revNeighbors[i];
+      }
+      m_offsets = offsets;
+      m_neighbors = neighbors;
+      m_revOffsets = revOffsets;
+      m_revNeighbors = revNeighbors;
+   }
+   else
+   {
+      allocateAdjList();
+      for (int i = 0; i < m_size; ++i)
+         m_adjList[i] = in_source.m_adjList[i];
+   }
+
    assert(isValidGraph(*this));
 }
 
+/******************************************************************************
+* GRAPH TAKE
+* Moves the storage of in_source into this (empty) Graph, leaving in_source
+* with nothing; it may then only be destroyed or assigned to
+******************************************************************************/
+void Graph::take(Graph & in_source)
+{
+   assert(m_adjList == NULL && m_arena == NULL && m_offsets == NULL);
+   m_size = in_source.m_size;
+   m_numCol = in_source.m_numCol;
+   m_numRow = in_source.m_numRow;
+   m_adjList = in_source.m_adjList;
+   m_arena = in_source.m_arena;
+   m_offsets = in_source.m_offsets;
+   m_neighbors = in_source.m_neighbors;
+   m_revOffsets = in_source.m_revOffsets;
+   m_revNeighbors = in_source.m_revNeighbors;
+   m_file = in_source.m_file;
+   m_pathCache = in_source.m_pathCache;
+
+   in_source.m_adjList = NULL;
+   in_source.m_arena = NULL;
+   in_source.m_offsets = NULL;
+   in_source.m_neighbors = NULL;
+   in_source.m_revOffsets = NULL;
+   in_source.m_revNeighbors = NULL;
+   in_source.m_file = NULL;
+   in_source.m_pathCache = NULL;
+}
+
 /******************************************************************************
 * GRAPH DESTROY
 * Destroys the internal structure of the Graph
 ******************************************************************************/
 void Graph::destroy()
 {
-   delete[] m_adjList;
-   m_adjList = NULL;
+   releaseAdjList();
+   releaseCsr();
+   disablePathCache();
 }
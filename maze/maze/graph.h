@@ -13,36 +13,202 @@
 
 #include "vertex.h"
 #include "set.h"
+#include "arena.h"
+#include "pathCache.h"
 #include <cassert>
 #include <vector>
 
 typedef Set<Vertex> VertexSet;
 typedef SetIterator<Vertex> VertexSetIterator;
-typedef VertexSet* AdjList;
+typedef Set<VertexId> VertexIdSet;
+typedef VertexIdSet* AdjList;
 
+// walks the neighbors of one vertex in place, in the packed CSR array or in
+// a vertex's edge set; both are plain arrays of VertexId
+typedef const VertexId * NeighborIterator;
+
+/******************************************************************************
+ * NEIGHBOR RANGE
+ * A non-owning view of the neighbors of one vertex. Only valid until the
+ * Graph is next modified.
+ ******************************************************************************/
+class NeighborRange
+{
+public:
+   NeighborRange(NeighborIterator in_begin, NeighborIterator in_end, int in_size)
+      : m_begin(in_begin), m_end(in_end), m_size(in_size) {}
+
+   NeighborIterator begin() const { return m_begin; }
+   NeighborIterator end() const { return m_end; }
+   int size() const { return m_size; }
+   bool empty() const { return m_size == 0; }
+
+private:
+   NeighborIterator m_begin;
+   NeighborIterator m_end;
+   int m_size;
+};
+
+class MappedFile;
+
+/******************************************************************************
+ * CSR ARRAYS
+ * The compressed sparse row arrays of a frozen Graph: the neighbors of
+ * vertex v are neighbors[offsets[v]] up to neighbors[offsets[v + 1]], and
+ * the vertices with an edge to v are listed the same way in the reverse
+ * arrays
+ ******************************************************************************/
+struct CsrArrays
+{
+   const int * offsets;
+   const VertexId * neighbors;
+   const int * revOffsets;
+   const VertexId * revNeighbors;
+};
+
+// one directed edge, for building a Graph all at once
+struct Edge
+{
+   VertexId from;
+   VertexId to;
+};
+
+// how findPath searches for the shortest path
+enum SearchMode
+{
+   SEARCH_FORWARD,         // breadth-first from the start only
+   SEARCH_BIDIRECTIONAL    // from both ends at once, meeting in the middle
+};
+
+/******************************************************************************
+ * GRAPH
+ * A directed graph of in_size vertices. Inside the Graph a vertex is just its
+ * VertexId; Vertex and its subclasses only appear at the edges of the
+ * interface. Edges are collected in a per-vertex VertexIdSet while the graph
+ * is being built, all carved from one Arena that is freed in one go. Once the
+ * graph is complete, freeze() packs them into a compressed sparse row (CSR)
+ * layout: one offset per vertex plus a single array of neighbor indices. A
+ * Graph built from an edge list goes straight to CSR without the edge sets.
+ * Queries run against whichever representation is current. A Graph read from
+ * a maze file also knows the maze's width and height, so mazes of any size
+ * can be held at once without touching the shared CVertex bounds. With the
+ * path cache enabled, findPath keeps the whole search tree from each start it
+ * sees and answers later queries from that start by walking the tree; adding,
+ * removing or clearing edges empties the cache. The const members only read
+ * the Graph, so any number of threads may call them at once as long as no
+ * thread is modifying it.
+ ******************************************************************************/
 class Graph
 {
 public:
    Graph(int in_size);
+   Graph(int in_numCol, int in_numRow);
+   Graph(int in_numCol, int in_numRow, const CsrArrays & in_arrays,
+         MappedFile * in_file);
+   Graph(int in_numCol, int in_numRow, const std::vector<Edge> & in_edges);
    Graph(const Graph & in_source);
+   Graph(Graph && in_source);
    ~Graph();
    int size() const { return m_size; }
+   int numCol() const { return m_numCol; }
+   int numRow() const { return m_numRow; }
    void add(Vertex & in_from, Vertex & in_to);
    void add(Vertex & in_from, VertexSet & in_to);
-   void clear() { }
+   void remove(Vertex & in_from, Vertex & in_to);
+   void clear();
+   void reserve(int in_numEdges);
+   ArenaStats allocationStats() const;
    bool isEdge(const Vertex & in_from, Vertex & in_to) const;
    VertexSet findEdges(const Vertex & in_from) const; 
+   NeighborRange neighbors(const Vertex & in_from) const;
+   template <class Visitor>
+   void forEachNeighbor(const Vertex & in_from, Visitor visit) const
+   {
+      forEachNeighbor(in_from.index(), visit);
+   }
+   template <class Visitor>
+   void forEachNeighbor(int in_from, Visitor visit) const;
    Graph & operator = (const Graph & in_source);
+   Graph & operator = (Graph && in_source);
    std::vector<Vertex> findPath() const;
    std::vector<Vertex> findPath(const Vertex & in_start, const Vertex & in_end) const;
+   std::vector<Vertex> findPath(const Vertex & in_start, const Vertex & in_end,
+                                SearchMode in_mode, int & out_expanded) const;
+   std::vector<int> distancesFrom(const Vertex & in_source) const;
+   void distancesFrom(const Vertex & in_source,
+                      std::vector<int> & out_distances,
+                      std::vector<VertexId> & io_queue) const;
+
+   // ordering the vertices along the edges, for graphs with no cycles
+   bool topologicalSort(std::vector<Vertex> & out_order) const;
+   std::vector<Vertex> findCycle() const;
+   std::vector<Vertex> longestPath(std::vector<int> & out_lengths) const;
+
+   // shortest-path trees kept for repeated queries from the same source
+   void enablePathCache(size_t in_budgetBytes);
+   void disablePathCache();
+   PathCacheStats pathCacheStats() const;
+
+   // compressed sparse row storage
+   void freeze();
+   bool isFrozen() const { return m_offsets != NULL; }
+   CsrArrays csr() const;
 
 private:
    bool isValidGraph(const Graph & in_graph) const;
-   bool vertexIsInBounds(const Vertex & in_vertex) const;
+   bool vertexIsInBounds(const Vertex & in_vertex) const
+   {
+      return in_vertex.index() >= 0 && in_vertex.index() < size();
+   }
+   void allocateAdjList();
+   void releaseAdjList();
    void clone(const Graph & in_source);
+   void take(Graph & in_source);
    void destroy();
+   void thaw();
+   void releaseCsr();
+   void buildReverse();
+   std::vector<Vertex> findPathForward(const Vertex & in_start,
+      const Vertex & in_end, int & out_expanded) const;
+   std::vector<Vertex> findPathBidirectional(const Vertex & in_start,
+      const Vertex & in_end, int & out_expanded) const;
+   std::vector<Vertex> findPathCached(const Vertex & in_start,
+      const Vertex & in_end) const;
 
    int m_size;
-   AdjList m_adjList;
+   int m_numCol;                    // a maze's width and height; a graph
+   int m_numRow;                    // that isn't a grid is one long row
+   AdjList m_adjList;               // per-vertex edge sets; NULL once frozen
+   Arena * m_arena;                 // where m_adjList and its sets live
+   const int * m_offsets;           // CSR: m_size + 1 offsets into m_neighbors
+   const VertexId * m_neighbors;    // CSR: every vertex's neighbors, sorted
+   const int * m_revOffsets;        // reverse CSR: offsets into m_revNeighbors
+   const VertexId * m_revNeighbors; // reverse CSR: every vertex's predecessors
+   MappedFile * m_file;             // where the CSR arrays live, if borrowed
+   PathCache * m_pathCache;         // shortest-path trees, if enabled
 };
+
+/******************************************************************************
+ * GRAPH FOR EACH NEIGHBOR
+ * Calls visit(index) for every vertex that has an edge from in_from, without
+ * copying the neighbors out of the Graph
+ ******************************************************************************/
+template <class Visitor>
+void Graph::forEachNeighbor(int in_from, Visitor visit) const
+{
+   assert(in_from >= 0 && in_from < size());
+   int from = in_from;
+
+   if (isFrozen())
+   {
+      for (int i = m_offsets[from]; i < m_offsets[from + 1]; ++i)
+         visit(m_neighbors[i]);
+   }
+   else
+   {
+      const VertexId * p = m_adjList[from].data();
+      for (int i = 0; i < m_adjList[from].size(); ++i)
+         visit(p[i]);
+   }
+}
 #endif
@@ -0,0 +1,97 @@
+/***********************************************************************
+* Component:
+*    Week 13, Grid Graph
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the GridGraph class
+************************************************************************/
+
+#include "gridGraph.h"
+#include "pathFinder.h"
+using namespace std;
+
+/******************************************************************************
+ * GRID GRAPH CONSTRUCTOR
+ * Creates a maze of in_numCol by in_numRow cells with every wall closed
+ ******************************************************************************/
+GridGraph::GridGraph(int in_numCol, int in_numRow)
+   : m_numCol(in_numCol), m_numRow(in_numRow)
+{
+   assert(m_numCol > 0 && m_numRow > 0);
+   m_bits.assign((size() + 3) / 4, 0);
+}
+
+/******************************************************************************
+ * GRID GRAPH ADD
+ * Opens the wall between two cells that are side by side or one above the
+ * other
+ ******************************************************************************/
+void GridGraph::add(const Vertex & in_from, const Vertex & in_to)
+{
+   assert(vertexIsInBounds(in_from));
+   assert(vertexIsInBounds(in_to));
+
+   int low = in_from.index() < in_to.index() ? in_from.index() : in_to.index();
+   int high = in_from.index() < in_to.index() ? in_to.index() : in_from.index();
+
+   if (high == low + 1 && high % m_numCol != 0)
+      open(low, OPEN_EAST);
+   else if (high == low + m_numCol)
+      open(low, OPEN_SOUTH);
+   else
+      throw "ERROR: A grid maze can only connect neighboring cells.";
+}
+
+/******************************************************************************
+ * GRID GRAPH IS EDGE
+ * Returns true if there is a passage between in_from and in_to
+ ******************************************************************************/
+bool GridGraph::isEdge(const Vertex & in_from, const Vertex & in_to) const
+{
+   assert(vertexIsInBounds(in_from));
+   assert(vertexIsInBounds(in_to));
+
+   int low = in_from.index() < in_to.index() ? in_from.index() : in_to.index();
+   int high = in_from.index() < in_to.index() ? in_to.index() : in_from.index();
+
+   if (high == low + 1 && high % m_numCol != 0)
+      return (openings(low) & OPEN_EAST) != 0;
+   if (high == low + m_numCol)
+      return (openings(low) & OPEN_SOUTH) != 0;
+   return false;
+}
+
+/******************************************************************************
+ * GRID GRAPH FIND EDGES
+ * Returns the set of cells with a passage to in_from
+ ******************************************************************************/
+Set<Vertex> GridGraph::findEdges(const Vertex & in_from) const
+{
+   Set<Vertex> edges(4);
+   forEachNeighbor(in_from, [&](int cell)
+   {
+      edges.insert(Vertex::fromIndex(cell));
+   });
+   return edges;
+}
+
+/******************************************************************************
+ * GRID GRAPH FIND PATH
+ * Finds the shortest path from the upper left cell to the lower right
+ ******************************************************************************/
+vector<Vertex> GridGraph::findPath() const
+{
+   return findPath(Vertex::fromIndex(0), Vertex::fromIndex(size() - 1));
+}
+
+/******************************************************************************
+ * GRID GRAPH FIND PATH
+ * Finds the shortest path from in_start to in_end, running from in_end back
+ * to in_start
+ ******************************************************************************/
+vector<Vertex> GridGraph::findPath(const Vertex & in_start, const Vertex & in_end) const
+{
+   PathFinder finder(*this);
+   return finder.findPath(in_start, in_end);
+}
@@ -0,0 +1,97 @@
+/***********************************************************************
+* Component:
+*    Week 13, Grid Graph
+* Author:
+*    Matthew Burr
+* Summary:
+*    A compact graph for rectangular mazes, where each cell can only
+*    connect to the cells beside, above and below it
+************************************************************************/
+
+#ifndef GRIDGRAPH_H
+#define GRIDGRAPH_H
+
+#include "vertex.h"
+#include "set.h"
+#include <cassert>
+#include <vector>
+
+// which walls of a cell have a passage through them
+#define OPEN_EAST  0x01
+#define OPEN_SOUTH 0x02
+
+/******************************************************************************
+ * GRID GRAPH
+ * A maze of numCol by numRow cells, numbered row by row like CVertex. Only
+ * two bits are stored per cell: whether there is a passage through its east
+ * wall and through its south wall. The west and north walls are the east and
+ * south walls of the neighboring cells. A passage can be walked either way,
+ * so adding an edge in one direction adds it in both.
+ ******************************************************************************/
+class GridGraph
+{
+public:
+   GridGraph(int in_numCol, int in_numRow);
+
+   int size() const { return m_numCol * m_numRow; }
+   int numCol() const { return m_numCol; }
+   int numRow() const { return m_numRow; }
+
+   void add(const Vertex & in_from, const Vertex & in_to);
+   bool isEdge(const Vertex & in_from, const Vertex & in_to) const;
+   Set<Vertex> findEdges(const Vertex & in_from) const;
+   template <class Visitor>
+   void forEachNeighbor(const Vertex & in_from, Visitor visit) const
+   {
+      forEachNeighbor(in_from.index(), visit);
+   }
+   template <class Visitor>
+   void forEachNeighbor(int in_from, Visitor visit) const;
+   std::vector<Vertex> findPath() const;
+   std::vector<Vertex> findPath(const Vertex & in_start, const Vertex & in_end) const;
+
+   // the OPEN_EAST and OPEN_SOUTH bits of one cell
+   int openings(int in_cell) const
+   {
+      return (m_bits[in_cell >> 2] >> ((in_cell & 3) << 1)) & 3;
+   }
+
+private:
+   void open(int in_cell, int in_wall)
+   {
+      m_bits[in_cell >> 2] |= (unsigned char)(in_wall << ((in_cell & 3) << 1));
+   }
+   bool vertexIsInBounds(const Vertex & in_vertex) const
+   {
+      return in_vertex.index() >= 0 && in_vertex.index() < size();
+   }
+
+   int m_numCol;
+   int m_numRow;
+   std::vector<unsigned char> m_bits;   // four cells to a byte
+};
+
+/******************************************************************************
+ * GRID GRAPH FOR EACH NEIGHBOR
+ * Calls visit(index) for every cell with a passage to in_from, in order of
+ * index: north, west, east, south
+ ******************************************************************************/
+template <class Visitor>
+void GridGraph::forEachNeighbor(int in_from, Visitor visit) const
+{
+   assert(in_from >= 0 && in_from < size());
+   int cell = in_from;
+
+   if (cell >= m_numCol && (openings(cell - m_numCol) & OPEN_SOUTH))
+      visit(cell - m_numCol);
+   if (cell % m_numCol != 0 && (openings(cell - 1) & OPEN_EAST))
+      visit(cell - 1);
+
+   int walls = openings(cell);
+   if (walls & OPEN_EAST)
+      visit(cell + 1);
+   if (walls & OPEN_SOUTH)
+      visit(cell + m_numCol);
+}
+
+#endif // GRIDGRAPH_H
@@ -0,0 +1,101 @@
+/***********************************************************************
+* Component:
+*    Week 13, Mapped File
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the MappedFile class
+************************************************************************/
+
+#include "mappedFile.h"
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// files smaller than this are read rather than mapped; mapping and
+// unmapping cost several times what reading a few pages does
+#define MAPPED_FILE_MIN_MAP (64 * 1024)
+
+/******************************************************************************
+ * MAPPED FILE CONSTRUCTOR
+ * Maps in_fileName into memory, or reads it if it is small. Check isOpen()
+ * to see if that worked.
+ ******************************************************************************/
+MappedFile::MappedFile(const char * in_fileName)
+   : m_data(NULL), m_size(0), m_isOpen(false), m_isMapped(false)
+{
+#ifndef _WIN32
+   int fd = open(in_fileName, O_RDONLY);
+   if (fd < 0)
+      return;
+
+   struct stat info;
+   if (fstat(fd, &info) == 0)
+   {
+      m_size = (size_t)info.st_size;
+      if (m_size == 0)
+         m_isOpen = true;   // nothing to map, but nothing went wrong either
+      else if (m_size < MAPPED_FILE_MIN_MAP)
+      {
+         char * buffer = new char[m_size];
+         size_t numRead = 0;
+         while (numRead < m_size)
+         {
+            ssize_t n = read(fd, buffer + numRead, m_size - numRead);
+            if (n <= 0)
+               break;
+            numRead += (size_t)n;
+         }
+         m_data = buffer;
+         m_isOpen = (numRead == m_size);
+      }
+      else
+      {
+         void * p = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+         if (p != MAP_FAILED)
+         {
+            m_data = (const char *)p;
+            m_isOpen = true;
+            m_isMapped = true;
+            madvise(p, m_size, MADV_SEQUENTIAL);
+         }
+      }
+   }
+   close(fd);
+#else
+   FILE * file = fopen(in_fileName, "rb");
+   if (file == NULL)
+      return;
+
+   fseek(file, 0, SEEK_END);
+   long size = ftell(file);
+   fseek(file, 0, SEEK_SET);
+   if (size >= 0)
+   {
+      char * buffer = new char[size > 0 ? size : 1];
+      m_size = fread(buffer, 1, (size_t)size, file);
+      m_data = buffer;
+      m_isOpen = (m_size == (size_t)size);
+   }
+   fclose(file);
+#endif
+}
+
+/******************************************************************************
+ * MAPPED FILE DESTRUCTOR
+ * Unmaps the file, or frees the buffer it was read into
+ ******************************************************************************/
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+   if (m_isMapped)
+      munmap((void *)m_data, m_size);
+   else
+#endif
+      delete[] m_data;
+}
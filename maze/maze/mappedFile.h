@@ -0,0 +1,43 @@
+/***********************************************************************
+* Component:
+*    Week 13, Mapped File
+* Author:
+*    Matthew Burr
+* Summary:
+*    Read-only access to the whole contents of a file, memory-mapped
+*    where the platform allows it
+************************************************************************/
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+/******************************************************************************
+ * MAPPED FILE
+ * Maps a file into memory for reading. The contents stay mapped until the
+ * MappedFile is destroyed. Where memory mapping isn't available, or the
+ * file is too small for it to pay, the file is read into a buffer instead.
+ ******************************************************************************/
+class MappedFile
+{
+public:
+   MappedFile(const char * in_fileName);
+   ~MappedFile();
+
+   bool isOpen() const { return m_isOpen; }
+   const char * begin() const { return m_data; }
+   const char * end() const { return m_data + m_size; }
+   size_t size() const { return m_size; }
+
+private:
+   MappedFile(const MappedFile &);
+   MappedFile & operator = (const MappedFile &);
+
+   const char * m_data;
+   size_t m_size;
+   bool m_isOpen;
+   bool m_isMapped;   // false if m_data is a buffer we allocated
+};
+
+#endif // MAPPEDFILE_H
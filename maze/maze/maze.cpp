@@ -9,19 +9,26 @@
  ************************************************************************/
 
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <cassert>
 #include "maze.h"
 #include "vertex.h"
-#include "set.h"
 #include "graph.h"
+#include "gridGraph.h"
+#include "mappedFile.h"
+#include "mazeParser.h"
+#include "mazeFile.h"
+#include "mazeGenerator.h"
+#include "streamingSolver.h"
 #include <vector>
 using namespace std;
 
-void drawMazeRow(const Graph & g, int row, Set <CVertex> & s);
-void drawMazeColumn(const Graph & g, int row, const Set <CVertex> & s);
+void findOpenings(const Graph & g, vector <char> & openings);
+template <class Openings>
+void renderMaze(const Openings & openings, int numCol, int numRow,
+                const vector <Vertex> & path, string & frame);
 Graph readMaze(const char * fileName);
+void reportParseError(const char * fileName, const ParseError & error);
 void drawMaze(const Graph & g, const vector <Vertex> & path);
 
 /******************************************
@@ -48,6 +55,104 @@ void solveMaze()
    drawMaze(maze, path);
 }
 
+/******************************************
+ * CONVERT MAZE TO BINARY
+ * Read a text maze from one file and write
+ * it to another in the binary format
+ *****************************************/
+void convertMazeToBinary()
+{
+   string textFileName;
+   string binaryFileName;
+   cout << "What is the text maze filename? ";
+   cin >> textFileName;
+   cout << "What is the binary maze filename? ";
+   cin >> binaryFileName;
+
+   if (convertMaze(textFileName.c_str(), binaryFileName.c_str()))
+      cout << "Wrote " << binaryFileName << endl;
+   else
+      cout << "ERROR: Unable to convert " << textFileName << endl;
+}
+
+/******************************************
+ * GENERATE MAZE
+ * Make a random maze with the algorithm,
+ * size, seed and braid asked for, and write
+ * it to a text file
+ *****************************************/
+void generateMaze()
+{
+   char algorithm;
+   int numCol;
+   int numRow;
+   unsigned int seed;
+   double braid;
+   string fileName;
+   cout << "Which algorithm: (b)acktracker, (k)ruskal, (w)ilson or (e)ller? ";
+   cin >> algorithm;
+   cout << "How many columns and rows? ";
+   cin >> numCol >> numRow;
+   cout << "What seed? ";
+   cin >> seed;
+   cout << "What share of dead ends to braid (0 to 1)? ";
+   cin >> braid;
+   cout << "What is the maze filename? ";
+   cin >> fileName;
+
+   MazeAlgorithm algorithms[] = { MAZE_BACKTRACKER, MAZE_KRUSKAL,
+                                  MAZE_WILSON, MAZE_ELLER };
+   const char * letters = "bkwe";
+   int which = 0;
+   while (which < 4 && letters[which] != algorithm)
+      which++;
+   if (!cin || which == 4)
+   {
+      cout << "ERROR: Unrecognized maze options\n";
+      return;
+   }
+
+   try
+   {
+      MazeGenerator generator(numCol, numRow, seed);
+      generator.setBraid(braid);
+      if (generator.write(algorithms[which], fileName.c_str()))
+         cout << "Wrote " << fileName << endl;
+      else
+         cout << "ERROR: Unable to write " << fileName << endl;
+   }
+   catch (const char * error)
+   {
+      cout << error << endl;
+   }
+}
+
+/******************************************
+ * SOLVE MAZE STREAMING
+ * Solve a maze in row order straight from
+ * its file, without loading it, and report
+ * how long the path is
+ *****************************************/
+void solveMazeStreaming()
+{
+   string fileName;
+   cout << "What is the filename? ";
+   cin >> fileName;
+
+   try
+   {
+      StreamingMazeSolver solver(fileName.c_str());
+      cout << "The maze is " << solver.numCol() << " by "
+           << solver.numRow() << endl;
+      vector<Vertex> path = solver.findPath();
+      cout << "The shortest path takes " << path.size() - 1 << " steps\n";
+   }
+   catch (const char * error)
+   {
+      cout << error << endl;
+   }
+}
+
 /************************************************
  * DRAW MAZE
  * Draw a given mze represented by the graph 'g'
@@ -57,33 +162,27 @@ void solveMaze()
  ***********************************************/
 void drawMaze(const Graph & g, const vector <Vertex> & path)
 {
-   CVertex v;
-
-   // copy everything into a set
-   Set <CVertex> s;
-   for (int i = 0; i < path.size(); i++)
-      s.insert((CVertex)path[i]);
+   // find the passages between cells once, up front
+   vector <char> openings;
+   findOpenings(g, openings);
 
-   // draw the top border
-   cout << "+  ";
-   for (int c = 1; c < v.getMaxCol(); c++)
-      cout << "+--";
-   cout << "+\n";
-
-   // draw a horizontal row
-   for (int row = 0; row < v.getMaxRow() - 1; row++)
-   {
-      drawMazeRow(g, row, s);
-      drawMazeColumn(g, row, s);
-   }
-
-   // draw the last row
-   drawMazeRow(g, v.getMaxRow() - 1, s);
+   string frame;
+   renderMaze([&](int cell) { return (int)openings[cell]; },
+              g.numCol(), g.numRow(), path, frame);
+   cout.write(frame.data(), frame.size());
+}
 
-   // draw the bottom border
-   for (int c = 0; c < v.getMaxCol() - 1; c++)
-      cout << "+--";
-   cout << "+  +\n";
+/************************************************
+ * DRAW MAZE
+ * Draw a maze stored as a GridGraph, which
+ * already knows the passages through each cell
+ ***********************************************/
+void drawMaze(const GridGraph & g, const vector <Vertex> & path)
+{
+   string frame;
+   renderMaze([&](int cell) { return g.openings(cell); },
+              g.numCol(), g.numRow(), path, frame);
+   cout.write(frame.data(), frame.size());
 }
 
 /*********************************************
@@ -92,97 +191,189 @@ void drawMaze(const Graph & g, const vector <Vertex> & path)
  ********************************************/
 Graph readMaze(const char * fileName)
 {
+   // a binary maze needs no parsing at all
+   if (isBinaryMaze(fileName))
+      return loadMaze(fileName);
+
    // attempt to open the file
-   ifstream fin (fileName);
-   if (fin.fail())
+   MappedFile file(fileName);
+   if (!file.isOpen())
    {
       cout << "ERROR: Unable to open file " << fileName << endl;
       return Graph(1);
    }
 
    // read the size from the beginning of the maze
+   MazeParser parser(file.begin(), file.end());
    int numCol;
    int numRow;
-   fin >> numCol >> numRow;
-   CVertex vFrom;
-   CVertex vTo;
-   vFrom.setMax(numCol, numRow);
+   if (!parser.readSize(numCol, numRow))
+   {
+      reportParseError(fileName, parser.error());
+      return Graph(1);
+   }
+   // now read all the items
+   vector<Edge> edges;
+   Edge edge;
+   while (parser.readEdge(edge.from, edge.to))
+      edges.push_back(edge);
 
-   // now read all the items and put them into the Graph
-   Graph g(vFrom.getMax());
-   while (fin >> vFrom >> vTo)
-      g.add(vFrom, vTo);
+   // everything up to a bad token is kept, but say where it was
+   if (parser.failed())
+      reportParseError(fileName, parser.error());
+
+   // and build the Graph, already packed for fast queries, in one pass
+   Graph g(numCol, numRow, edges);
 
    // all done!
-   fin.close();
    return g;
 
 }
 
-/**********************************************
- * DRAW MAZE ROW
- * Draw all the horizontal tunnels on a given row
- *********************************************/
-void drawMazeRow(const Graph & g, int row, Set <CVertex> & s)
+/*********************************************
+ * READ GRID MAZE
+ * Read a text maze from the file into the
+ * compact GridGraph form
+ ********************************************/
+GridGraph readGridMaze(const char * fileName)
 {
-   const char * space = NULL;
-   
-   CVertex vFrom;
-   CVertex vTo;
-   assert(g.size() == vFrom.getMaxCol() * vFrom.getMaxRow());
-
-   // they all start with a #
-   cout << "|";
+   // attempt to open the file
+   MappedFile file(fileName);
+   if (!file.isOpen())
+   {
+      cout << "ERROR: Unable to open file " << fileName << endl;
+      return GridGraph(1, 1);
+   }
 
-   // for every column in the row
-   for (int col = 1; col < vFrom.getMaxCol(); col++)
+   // read the size from the beginning of the maze
+   MazeParser parser(file.begin(), file.end());
+   int numCol;
+   int numRow;
+   if (!parser.readSize(numCol, numRow))
    {
-      // set the position
-      vFrom.set(col, row);
-      vTo.set(col - 1, row);
-      space = (s.end() == s.find(vTo) ? "  " : "##");
-      
-      // draw
-      if (g.isEdge(vFrom, vTo) || g.isEdge(vTo, vFrom))
-         cout << space << ' ';
-      else
-         cout << space << '|';
+      reportParseError(fileName, parser.error());
+      return GridGraph(1, 1);
    }
+   // now open a passage for every pair of cells
+   GridGraph g(numCol, numRow);
+   int from;
+   int to;
+   while (parser.readEdge(from, to))
+      g.add(Vertex::fromIndex(from), Vertex::fromIndex(to));
+
+   // everything up to a bad token is kept, but say where it was
+   if (parser.failed())
+      reportParseError(fileName, parser.error());
 
-   // draw the end of row marker
-   vTo.set( vFrom.getMaxCol() - 1, row);
-   space = (s.end() == s.find(vTo) ? "  " : "##");
-   cout << space << "|\n";
+   return g;
+}
+
+/*********************************************
+ * REPORT PARSE ERROR
+ * Say where a maze file stopped making sense
+ ********************************************/
+void reportParseError(const char * fileName, const ParseError & error)
+{
+   cout << "ERROR: " << fileName << ", line " << error.line
+        << ", column " << error.column << ": " << error.message << endl;
 }
 
 /**********************************************
- * DRAW MAZE COLUMN
- * Draw all the vertical tunnels on a given row
+ * FIND OPENINGS
+ * Walk every edge of the maze once and record,
+ * for each cell, whether its east and south
+ * walls have a passage through them
  *********************************************/
-void drawMazeColumn(const Graph & g, int row, const Set <CVertex> & s)
+void findOpenings(const Graph & g, vector <char> & openings)
 {
-   CVertex vFrom;
-   CVertex vTo;
-   assert(g.size() == vFrom.getMaxCol() * vFrom.getMaxRow());
+   int numCol = g.numCol();
 
-   // they all start with a #
-   cout << "+";
+   openings.assign(g.size(), 0);
+   for (int i = 0; i < g.size(); i++)
+      g.forEachNeighbor(i, [&](int j)
+      {
+         // an edge in either direction opens the wall between the cells
+         int low  = i < j ? i : j;
+         int high = i < j ? j : i;
+         if (high == low + 1 && high % numCol != 0)
+            openings[low] |= OPEN_EAST;
+         else if (high == low + numCol)
+            openings[low] |= OPEN_SOUTH;
+      });
+}
 
-   // for every column in the row
-   for (int col = 0; col < vFrom.getMaxCol(); col++)
+/**********************************************
+ * RENDER MAZE
+ * Build the whole picture of a maze in one
+ * buffer. openings(cell) gives the OPEN_EAST
+ * and OPEN_SOUTH bits of each cell. Every line
+ * of the picture is 3 * numCol + 2 characters
+ * and there are 2 * numRow + 1 of them, so the
+ * buffer is sized once and filled in place.
+ *********************************************/
+template <class Openings>
+void renderMaze(const Openings & openings, int numCol, int numRow,
+                const vector <Vertex> & path, string & frame)
+{
+   assert(numCol > 0 && numRow > 0);
+   int numCells = numCol * numRow;
+
+   // mark the cells on the path, one bit each
+   vector <unsigned char> onPath((numCells + 7) / 8, 0);
+   for (size_t i = 0; i < path.size(); i++)
    {
-      // set the position
-      vFrom.set(col, row);
-      vTo.set(col, row + 1);
+      int cell = path[i].index();
+      assert(cell >= 0 && cell < numCells);
+      onPath[cell >> 3] |= (unsigned char)(1 << (cell & 7));
+   }
 
-      // draw
-      if (g.isEdge(vFrom, vTo) || g.isEdge(vTo, vFrom))
-         cout << "  +";
-      else
-         cout << "--+";
+   size_t lineLength = 3 * (size_t)numCol + 2;
+   frame.resize(lineLength * (2 * (size_t)numRow + 1));
+   char * p = &frame[0];
+
+   // draw the top border
+   *p++ = '+'; *p++ = ' '; *p++ = ' ';
+   for (int col = 1; col < numCol; col++)
+   {
+      *p++ = '+'; *p++ = '-'; *p++ = '-';
    }
+   *p++ = '+'; *p++ = '\n';
 
-   // draw the end of row marker
-   cout << endl;
-}
+   for (int row = 0; row < numRow; row++)
+   {
+      // draw the horizontal tunnels on this row
+      *p++ = '|';
+      for (int col = 0; col < numCol; col++)
+      {
+         int cell = row * numCol + col;
+         char space = (onPath[cell >> 3] >> (cell & 7)) & 1 ? '#' : ' ';
+         *p++ = space;
+         *p++ = space;
+         *p++ = (col < numCol - 1 && (openings(cell) & OPEN_EAST)) ? ' ' : '|';
+      }
+      *p++ = '\n';
 
+      // draw the vertical tunnels below it, or the bottom border
+      if (row < numRow - 1)
+      {
+         *p++ = '+';
+         for (int col = 0; col < numCol; col++)
+         {
+            bool isOpen = (openings(row * numCol + col) & OPEN_SOUTH) != 0;
+            *p++ = isOpen ? ' ' : '-';
+            *p++ = isOpen ? ' ' : '-';
+            *p++ = '+';
+         }
+         *p++ = '\n';
+      }
+   }
+
+   // draw the bottom border, open at the lower right
+   for (int col = 0; col < numCol - 1; col++)
+   {
+      *p++ = '+'; *p++ = '-'; *p++ = '-';
+   }
+   *p++ = '+'; *p++ = ' '; *p++ = ' '; *p++ = '+'; *p++ = '\n';
+
+   assert(p == &frame[0] + frame.size());
+}
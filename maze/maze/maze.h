@@ -13,15 +13,29 @@
 #define MAZE_H
 
 #include "graph.h"
+#include "gridGraph.h"
 #include <vector>
 
 // solve the maze, the main program function
 void solveMaze();
 
-// read a maze in from a file
+// read a maze in from a file, text or binary
 Graph readMaze(const char * fileName);
 
+// read a maze in from a text file into the compact grid form
+GridGraph readGridMaze(const char * fileName);
+
+// convert a text maze to the binary format, prompting for the files
+void convertMazeToBinary();
+
+// generate a random maze into a text file, prompting for how
+void generateMaze();
+
+// solve a maze too big to load, a row at a time from its file
+void solveMazeStreaming();
+
 // display a maze on the screen
 void drawMaze(const Graph & g, const std::vector <Vertex> & path);
+void drawMaze(const GridGraph & g, const std::vector <Vertex> & path);
 
 #endif // MAZE_H
@@ -0,0 +1,248 @@
+/***********************************************************************
+* Component:
+*    Week 13, Maze File
+* Author:
+*    Matthew Burr
+* Summary:
+*    Reads and writes the binary maze format
+************************************************************************/
+
+#include "mazeFile.h"
+#include "mappedFile.h"
+#include "maze.h"
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#define MAZE_FILE_BYTE_ORDER 0x01020304
+
+unsigned int checksumInts(const int * data, int count, unsigned int sum);
+bool writeInts(FILE * file, const int * data, int count);
+bool isValidCsr(const int * offsets, const int * neighbors,
+                int numVertices, int numEdges);
+bool isTranspose(const CsrArrays & arrays, int numVertices);
+
+/*********************************************
+ * IS BINARY MAZE
+ * Checks whether a file starts with the binary
+ * maze file's magic number
+ ********************************************/
+bool isBinaryMaze(const char * fileName)
+{
+   char magic[4];
+   FILE * file = fopen(fileName, "rb");
+   if (file == NULL)
+      return false;
+
+   bool isBinary = fread(magic, 1, 4, file) == 4 &&
+                   memcmp(magic, "MAZE", 4) == 0;
+   fclose(file);
+   return isBinary;
+}
+
+/*********************************************
+ * SAVE MAZE
+ * Writes the header, then the frozen Graph's
+ * arrays exactly as they sit in memory
+ ********************************************/
+bool saveMaze(const Graph & g, const char * fileName)
+{
+   assert(g.isFrozen());
+
+   CsrArrays arrays = g.csr();
+   int numVertices = g.size();
+   int numEdges = arrays.offsets[numVertices];
+
+   MazeFileHeader header;
+   memcpy(header.magic, "MAZE", 4);
+   header.version = MAZE_FILE_VERSION;
+   header.byteOrder = MAZE_FILE_BYTE_ORDER;
+   header.numCol = g.numCol();
+   header.numRow = g.numRow();
+   header.numVertices = numVertices;
+   header.numEdges = numEdges;
+   header.checksum = checksumInts(arrays.offsets, numVertices + 1, 0);
+   header.checksum = checksumInts(arrays.neighbors, numEdges, header.checksum);
+   header.checksum = checksumInts(arrays.revOffsets, numVertices + 1, header.checksum);
+   header.checksum = checksumInts(arrays.revNeighbors, numEdges, header.checksum);
+
+   FILE * file = fopen(fileName, "wb");
+   if (file == NULL)
+      return false;
+
+   bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             writeInts(file, arrays.offsets, numVertices + 1) &&
+             writeInts(file, arrays.neighbors, numEdges) &&
+             writeInts(file, arrays.revOffsets, numVertices + 1) &&
+             writeInts(file, arrays.revNeighbors, numEdges);
+   return fclose(file) == 0 && ok;
+}
+
+/*********************************************
+ * LOAD MAZE
+ * Maps a binary maze into memory and hands the
+ * arrays to a Graph where they lie. The header
+ * is checked field by field, with its sizes
+ * worked out in 64 bits so a hostile one can't
+ * overflow them; the arrays are checked against
+ * the checksum, and then for structure, since a
+ * checksum can be right for arrays that point
+ * outside the Graph, aren't sorted for isEdge's
+ * binary search, or have reverse arrays that
+ * disagree with the forward ones.
+ ********************************************/
+Graph loadMaze(const char * fileName)
+{
+   MappedFile * file = new MappedFile(fileName);
+   const char * problem = NULL;
+   const MazeFileHeader * header = (const MazeFileHeader *)file->begin();
+
+   if (!file->isOpen())
+      problem = "Unable to open file";
+   else if (file->size() < sizeof(MazeFileHeader) ||
+            memcmp(header->magic, "MAZE", 4) != 0)
+      problem = "Not a binary maze file";
+   else if (header->version != MAZE_FILE_VERSION)
+      problem = "Unsupported binary maze version";
+   else if (header->byteOrder != MAZE_FILE_BYTE_ORDER)
+      problem = "Binary maze was written with a different byte order";
+   else if (header->numCol <= 0 || header->numRow <= 0 ||
+            header->numVertices !=
+               (long long)header->numCol * header->numRow ||
+            header->numEdges < 0 ||
+            2 * ((long long)header->numVertices + 1 + header->numEdges) >
+               INT_MAX ||
+            file->size() != sizeof(MazeFileHeader) + sizeof(int) *
+               (2 * (size_t)header->numVertices + 2 + 2 * (size_t)header->numEdges))
+      problem = "Binary maze file is the wrong size";
+
+   CsrArrays arrays;
+   if (problem == NULL)
+   {
+      arrays.offsets = (const int *)(header + 1);
+      arrays.neighbors = arrays.offsets + header->numVertices + 1;
+      arrays.revOffsets = arrays.neighbors + header->numEdges;
+      arrays.revNeighbors = arrays.revOffsets + header->numVertices + 1;
+
+      unsigned int sum = checksumInts(arrays.offsets,
+         2 * (header->numVertices + 1 + header->numEdges), 0);
+      if (sum != header->checksum ||
+          !isValidCsr(arrays.offsets, arrays.neighbors,
+                      header->numVertices, header->numEdges) ||
+          !isValidCsr(arrays.revOffsets, arrays.revNeighbors,
+                      header->numVertices, header->numEdges) ||
+          !isTranspose(arrays, header->numVertices))
+         problem = "Binary maze file is corrupt";
+   }
+
+   if (problem != NULL)
+   {
+      cout << "ERROR: " << problem << " " << fileName << endl;
+      delete file;
+      return Graph(1);
+   }
+
+   return Graph(header->numCol, header->numRow, arrays, file);
+}
+
+/*********************************************
+ * CONVERT MAZE
+ * Reads a text maze and saves it in binary
+ ********************************************/
+bool convertMaze(const char * textFileName, const char * binaryFileName)
+{
+   Graph g = readMaze(textFileName);
+   if (!g.isFrozen())
+      return false;
+   return saveMaze(g, binaryFileName);
+}
+
+/*********************************************
+ * CHECKSUM INTS
+ * Folds count ints into a running Fletcher
+ * style checksum
+ ********************************************/
+unsigned int checksumInts(const int * data, int count, unsigned int sum)
+{
+   unsigned long long low = sum & 0xffff;
+   unsigned long long high = sum >> 16;
+   for (int i = 0; i < count; ++i)
+   {
+      low += (unsigned int)data[i];
+      high += low;
+      // fold before the running sums can overflow
+      if ((i & 0xfff) == 0xfff)
+      {
+         low %= 0xffff;
+         high %= 0xffff;
+      }
+   }
+   low %= 0xffff;
+   high %= 0xffff;
+   return (unsigned int)(high << 16 | low);
+}
+
+/*********************************************
+ * WRITE INTS
+ * Writes count ints to the file
+ ********************************************/
+bool writeInts(FILE * file, const int * data, int count)
+{
+   return count == 0 ||
+      fwrite(data, sizeof(int), (size_t)count, file) == (size_t)count;
+}
+
+/*********************************************
+ * IS VALID CSR
+ * Checks that one pair of CSR arrays describes
+ * numEdges edges among numVertices vertices:
+ * the offsets start at 0, never go down and end
+ * at numEdges, and every neighbor is a vertex,
+ * each list strictly increasing, so sorted for
+ * binary search and with no edge twice
+ ********************************************/
+bool isValidCsr(const int * offsets, const int * neighbors,
+                int numVertices, int numEdges)
+{
+   if (offsets[0] != 0 || offsets[numVertices] != numEdges)
+      return false;
+   for (int v = 0; v < numVertices; ++v)
+   {
+      if (offsets[v] > offsets[v + 1])
+         return false;
+      for (int i = offsets[v]; i < offsets[v + 1]; ++i)
+         if (neighbors[i] < 0 || neighbors[i] >= numVertices ||
+             (i > offsets[v] && neighbors[i] <= neighbors[i - 1]))
+            return false;
+   }
+   return true;
+}
+
+/*********************************************
+ * IS TRANSPOSE
+ * Checks that the reverse arrays hold exactly
+ * the forward edges turned around, as freeze()
+ * builds them: walking the forward edges in
+ * order of their source, each must be the next
+ * entry of its destination's reverse list. Both
+ * pairs must already have passed isValidCsr,
+ * so the lists are the same total length and
+ * none can be left over.
+ ********************************************/
+bool isTranspose(const CsrArrays & arrays, int numVertices)
+{
+   vector<int> fill(arrays.revOffsets, arrays.revOffsets + numVertices);
+   for (int v = 0; v < numVertices; ++v)
+      for (int i = arrays.offsets[v]; i < arrays.offsets[v + 1]; ++i)
+      {
+         int w = arrays.neighbors[i];
+         if (fill[w] == arrays.revOffsets[w + 1] ||
+             arrays.revNeighbors[fill[w]] != v)
+            return false;
+         fill[w]++;
+      }
+   return true;
+}
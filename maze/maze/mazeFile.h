@@ -0,0 +1,49 @@
+/***********************************************************************
+* Component:
+*    Week 13, Maze File
+* Author:
+*    Matthew Burr
+* Summary:
+*    A binary file format for mazes that loads without any parsing
+************************************************************************/
+
+#ifndef MAZEFILE_H
+#define MAZEFILE_H
+
+#include "graph.h"
+
+#define MAZE_FILE_VERSION 1
+
+/******************************************************************************
+ * MAZE FILE HEADER
+ * The start of a binary maze file. It is followed by the Graph's compressed
+ * sparse row arrays, each a run of 32 bit ints in the machine's byte order:
+ * offsets (numVertices + 1), neighbors (numEdges), reverse offsets
+ * (numVertices + 1) and reverse neighbors (numEdges). The checksum covers
+ * all four arrays.
+ ******************************************************************************/
+struct MazeFileHeader
+{
+   char magic[4];              // "MAZE"
+   int version;                // MAZE_FILE_VERSION
+   int byteOrder;              // 0x01020304 as written by the saving machine
+   int numCol;
+   int numRow;
+   int numVertices;
+   int numEdges;
+   unsigned int checksum;
+};
+
+// is this file in the binary format?
+bool isBinaryMaze(const char * fileName);
+
+// write a frozen maze to a binary file
+bool saveMaze(const Graph & g, const char * fileName);
+
+// map a binary maze file straight into a Graph
+Graph loadMaze(const char * fileName);
+
+// read a text maze and write it out in the binary format
+bool convertMaze(const char * textFileName, const char * binaryFileName);
+
+#endif // MAZEFILE_H
@@ -0,0 +1,533 @@
+/***********************************************************************
+* Component:
+*    Week 13, Maze Generator
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the MazeGenerator class
+************************************************************************/
+
+#include "mazeGenerator.h"
+#include <cassert>
+#include <cstdio>
+#include <string>
+using namespace std;
+
+// the directions out of a cell, in the order neighbors are tried
+#define MAZE_EAST  0
+#define MAZE_SOUTH 1
+#define MAZE_WEST  2
+#define MAZE_NORTH 3
+
+// find the set a column is in, in a union-find array
+static int findSet(vector<int> & io_sets, int in_item)
+{
+   while (io_sets[in_item] != in_item)
+      in_item = io_sets[in_item] = io_sets[io_sets[in_item]];
+   return in_item;
+}
+
+/******************************************************************************
+ * MAZE GENERATOR CONSTRUCTOR
+ * Sets up to make perfect in_numCol by in_numRow mazes from in_seed
+ ******************************************************************************/
+MazeGenerator::MazeGenerator(int in_numCol, int in_numRow,
+                             unsigned int in_seed)
+   : m_numCol(in_numCol), m_numRow(in_numRow), m_seed(in_seed), m_braid(0),
+     m_state(0), m_coins(0), m_numCoins(0)
+{
+   if (in_numCol <= 0 || in_numRow <= 0 || in_numRow > INT_MAX / in_numCol)
+      throw "ERROR: A maze needs at least one cell and fewer than 2^31.";
+}
+
+/******************************************************************************
+ * MAZE GENERATOR SET BRAID
+ * Has every maze open one more wall at in_fraction of its dead ends: 0 for
+ * a perfect maze, 1 to leave hardly any dead ends at all
+ ******************************************************************************/
+void MazeGenerator::setBraid(double in_fraction)
+{
+   if (in_fraction < 0.0)
+      in_fraction = 0.0;
+   if (in_fraction > 1.0)
+      in_fraction = 1.0;
+   m_braid = (unsigned int)(in_fraction * 65536.0 + 0.5);
+}
+
+/******************************************************************************
+ * MAZE GENERATOR GENERATE
+ * Makes a maze with in_algorithm, braids it, and hands it to in_visit one
+ * row at a time, top to bottom
+ ******************************************************************************/
+void MazeGenerator::generate(MazeAlgorithm in_algorithm,
+                             const MazeRowVisitor & in_visit)
+{
+   // splitmix64 spreads the seed over the whole state, which can't be zero
+   unsigned long long z = m_seed + 0x9e3779b97f4a7c15ULL;
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+   m_state = (z ^ (z >> 31)) | 1;
+   m_numCoins = 0;
+
+   if (in_algorithm == MAZE_ELLER)
+   {
+      eller(in_visit);
+      return;
+   }
+
+   vector<unsigned char> cells((size_t)m_numCol * m_numRow, 0);
+   switch (in_algorithm)
+   {
+      case MAZE_BACKTRACKER:
+         backtracker(cells);
+         break;
+      case MAZE_KRUSKAL:
+         kruskal(cells);
+         break;
+      case MAZE_WILSON:
+         wilson(cells);
+         break;
+      default:
+         throw "ERROR: Unknown maze algorithm.";
+   }
+
+   for (int row = 0; row < m_numRow; ++row)
+   {
+      unsigned char * cell = &cells[(size_t)row * m_numCol];
+      braidRow(row > 0 ? cell - m_numCol : NULL, cell, row == m_numRow - 1);
+      in_visit(row, cell);
+   }
+}
+
+/******************************************************************************
+ * MAZE GENERATOR GENERATE
+ * Makes a maze as an edge list, both directions of every passage, ready for
+ * the Graph constructor that takes one
+ ******************************************************************************/
+void MazeGenerator::generate(MazeAlgorithm in_algorithm,
+                             vector<Edge> & out_edges)
+{
+   out_edges.clear();
+   out_edges.reserve((size_t)m_numCol * m_numRow * 2);
+
+   int numCol = m_numCol;
+   generate(in_algorithm, [&](int row, const unsigned char * openings)
+   {
+      int cell = row * numCol;
+      for (int col = 0; col < numCol; ++col, ++cell)
+      {
+         if (openings[col] & OPEN_EAST)
+         {
+            Edge east = { cell, cell + 1 };
+            Edge west = { cell + 1, cell };
+            out_edges.push_back(east);
+            out_edges.push_back(west);
+         }
+         if (openings[col] & OPEN_SOUTH)
+         {
+            Edge south = { cell, cell + numCol };
+            Edge north = { cell + numCol, cell };
+            out_edges.push_back(south);
+            out_edges.push_back(north);
+         }
+      }
+   });
+}
+
+/******************************************************************************
+ * MAZE GENERATOR GENERATE
+ * Makes a maze as a frozen Graph
+ ******************************************************************************/
+Graph MazeGenerator::generate(MazeAlgorithm in_algorithm)
+{
+   vector<Edge> edges;
+   generate(in_algorithm, edges);
+   return Graph(m_numCol, m_numRow, edges);
+}
+
+/******************************************************************************
+ * MAZE GENERATOR WRITE
+ * Makes a maze and writes it to in_fileName in the text format readMaze
+ * reads: the size, then one line per row holding both directions of each
+ * passage out of its cells to the east and south. Each row is written as
+ * soon as it is made, so with MAZE_ELLER the whole maze is never in memory.
+ ******************************************************************************/
+bool MazeGenerator::write(MazeAlgorithm in_algorithm, const char * in_fileName)
+{
+   FILE * file = fopen(in_fileName, "w");
+   if (file == NULL)
+      return false;
+
+   bool isOk = fprintf(file, "%d %d\n", m_numCol, m_numRow) > 0;
+   string line;
+   int numCol = m_numCol;
+   generate(in_algorithm, [&](int row, const unsigned char * openings)
+   {
+      // one coordinate ahead: this cell's east neighbor's text is the next
+      // cell's own
+      char here[COORDINATE_TEXT_MAX];
+      char east[COORDINATE_TEXT_MAX];
+      char south[COORDINATE_TEXT_MAX];
+      int hereLength = formatCoordinate(0, row, here);
+
+      line.clear();
+      for (int col = 0; col < numCol; ++col)
+      {
+         int eastLength = 0;
+         if (col + 1 < numCol)
+            eastLength = formatCoordinate(col + 1, row, east);
+         if (openings[col] & OPEN_EAST)
+         {
+            line.append(here, hereLength).append(1, ' ');
+            line.append(east, eastLength).append(3, ' ');
+            line.append(east, eastLength).append(1, ' ');
+            line.append(here, hereLength).append(3, ' ');
+         }
+         if (openings[col] & OPEN_SOUTH)
+         {
+            int southLength = formatCoordinate(col, row + 1, south);
+            line.append(here, hereLength).append(1, ' ');
+            line.append(south, southLength).append(3, ' ');
+            line.append(south, southLength).append(1, ' ');
+            line.append(here, hereLength).append(3, ' ');
+         }
+         for (int i = 0; i < eastLength; ++i)
+            here[i] = east[i];
+         hereLength = eastLength;
+      }
+      line += '\n';
+      isOk = isOk && fwrite(line.data(), 1, line.size(), file) == line.size();
+   });
+
+   return fclose(file) == 0 && isOk;
+}
+
+/******************************************************************************
+ * MAZE GENERATOR BACKTRACKER
+ * Depth-first from a random cell: keep carving into a random unvisited
+ * neighbor, and back up along an explicit stack when there is none
+ ******************************************************************************/
+void MazeGenerator::backtracker(vector<unsigned char> & out_cells)
+{
+   int numCells = m_numCol * m_numRow;
+   vector<char> isVisited(numCells, 0);
+   vector<int> stack;
+   stack.reserve(numCells);
+
+   int start = (int)random(numCells);
+   isVisited[start] = 1;
+   stack.push_back(start);
+   while (!stack.empty())
+   {
+      int cell = stack.back();
+      int col = cell % m_numCol;
+      int options[4];
+      int numOptions = 0;
+      if (col + 1 < m_numCol && !isVisited[cell + 1])
+         options[numOptions++] = cell + 1;
+      if (cell + m_numCol < numCells && !isVisited[cell + m_numCol])
+         options[numOptions++] = cell + m_numCol;
+      if (col > 0 && !isVisited[cell - 1])
+         options[numOptions++] = cell - 1;
+      if (cell >= m_numCol && !isVisited[cell - m_numCol])
+         options[numOptions++] = cell - m_numCol;
+
+      if (numOptions == 0)
+      {
+         stack.pop_back();
+         continue;
+      }
+      int next = options[random(numOptions)];
+      carve(out_cells, cell, next);
+      isVisited[next] = 1;
+      stack.push_back(next);
+   }
+}
+
+/******************************************************************************
+ * MAZE GENERATOR KRUSKAL
+ * Every wall in random order, each knocked down if the cells on either side
+ * aren't yet joined
+ ******************************************************************************/
+void MazeGenerator::kruskal(vector<unsigned char> & out_cells)
+{
+   int numCells = m_numCol * m_numRow;
+
+   // a wall is its cell times two, plus one for the south wall
+   vector<int> walls;
+   walls.reserve((size_t)numCells * 2);
+   for (int cell = 0; cell < numCells; ++cell)
+   {
+      if (cell % m_numCol + 1 < m_numCol)
+         walls.push_back(cell * 2);
+      if (cell + m_numCol < numCells)
+         walls.push_back(cell * 2 + 1);
+   }
+   for (int i = (int)walls.size() - 1; i > 0; --i)
+   {
+      int j = (int)random(i + 1);
+      int wall = walls[i];
+      walls[i] = walls[j];
+      walls[j] = wall;
+   }
+
+   vector<int> sets(numCells);
+   for (int cell = 0; cell < numCells; ++cell)
+      sets[cell] = cell;
+
+   int numPassages = 0;
+   for (size_t i = 0; i < walls.size() && numPassages < numCells - 1; ++i)
+   {
+      int cell = walls[i] / 2;
+      int other = walls[i] & 1 ? cell + m_numCol : cell + 1;
+      int a = findSet(sets, cell);
+      int b = findSet(sets, other);
+      if (a != b)
+      {
+         sets[b] = a;
+         carve(out_cells, cell, other);
+         numPassages++;
+      }
+   }
+}
+
+/******************************************************************************
+ * MAZE GENERATOR WILSON
+ * Starting from one random cell in the maze, walk at random from each cell
+ * not yet in it until the walk hits the maze, then carve the walk with its
+ * loops erased. Remembering only the last way out of each cell erases them.
+ ******************************************************************************/
+void MazeGenerator::wilson(vector<unsigned char> & out_cells)
+{
+   int numCells = m_numCol * m_numRow;
+   vector<char> isInMaze(numCells, 0);
+   vector<int> next(numCells, -1);
+   isInMaze[random(numCells)] = 1;
+
+   for (int start = 0; start < numCells; ++start)
+   {
+      if (isInMaze[start])
+         continue;
+
+      int cell = start;
+      while (!isInMaze[cell])
+      {
+         int col = cell % m_numCol;
+         int options[4];
+         int numOptions = 0;
+         if (col + 1 < m_numCol)
+            options[numOptions++] = cell + 1;
+         if (cell + m_numCol < numCells)
+            options[numOptions++] = cell + m_numCol;
+         if (col > 0)
+            options[numOptions++] = cell - 1;
+         if (cell >= m_numCol)
+            options[numOptions++] = cell - m_numCol;
+         next[cell] = options[random(numOptions)];
+         cell = next[cell];
+      }
+
+      for (cell = start; !isInMaze[cell]; cell = next[cell])
+      {
+         isInMaze[cell] = 1;
+         carve(out_cells, cell, next[cell]);
+      }
+   }
+}
+
+/******************************************************************************
+ * MAZE GENERATOR ELLER
+ * One row at a time, knowing only which cells of the row are already joined
+ * by the rows above. Neighbors not yet joined are joined at random; then
+ * every set gets at least one passage down, and the cells below those
+ * passages start the next row in the same sets. The last row joins every
+ * neighbor not yet joined, so the whole maze is connected. The sets are a
+ * union-find over the row's columns, and every array is one row long.
+ ******************************************************************************/
+void MazeGenerator::eller(const MazeRowVisitor & in_visit)
+{
+   int numCol = m_numCol;
+   vector<int> sets(numCol);              // this row's union-find
+   vector<int> label(numCol);             // the row above's sets, settled
+   vector<int> first(numCol, -1);         // the set's first column below
+   vector<int> count(numCol, 0);          // cells without a passage down
+   vector<int> chosen(numCol, 0);         // the one that gets one anyway
+   vector<char> hasPassageDown(numCol, 0);
+   vector<unsigned char> above(numCol, 0);
+   vector<unsigned char> openings(numCol, 0);
+
+   for (int row = 0; row < m_numRow; ++row)
+   {
+      bool isLastRow = row == m_numRow - 1;
+
+      // cells under a passage join the set above them; the rest start
+      // sets of their own
+      for (int col = 0; col < numCol; ++col)
+         label[col] = row > 0 ? findSet(sets, col) : col;
+      for (int col = 0; col < numCol; ++col)
+      {
+         sets[col] = col;
+         if (above[col] & OPEN_SOUTH)
+         {
+            if (first[label[col]] == -1)
+               first[label[col]] = col;
+            else
+               sets[col] = first[label[col]];
+         }
+      }
+      for (int col = 0; col < numCol; ++col)
+         first[label[col]] = -1;
+
+      // join neighbors at random, and all of them on the last row
+      for (int col = 0; col < numCol; ++col)
+         openings[col] = 0;
+      int a = findSet(sets, 0);
+      for (int col = 0; col + 1 < numCol; ++col)
+      {
+         int b = findSet(sets, col + 1);
+         if (a != b && (isLastRow || coin()))
+         {
+            sets[b] = a;
+            openings[col] |= OPEN_EAST;
+         }
+         else
+            a = b;
+      }
+
+      // passages down at random, then one for each set that got none,
+      // picked fairly among its cells. Settle every cell's set first, so
+      // each pass below is a plain lookup.
+      if (!isLastRow)
+      {
+         for (int col = 0; col < numCol; ++col)
+            label[col] = findSet(sets, col);
+         for (int col = 0; col < numCol; ++col)
+         {
+            int isDown = coin();
+            openings[col] |= isDown * OPEN_SOUTH;
+            hasPassageDown[label[col]] |= isDown;
+         }
+         for (int col = 0; col < numCol; ++col)
+         {
+            int set = label[col];
+            if (!hasPassageDown[set] && random(++count[set]) == 0)
+               chosen[set] = col;
+         }
+         for (int col = 0; col < numCol; ++col)
+         {
+            int set = label[col];
+            if (!hasPassageDown[set] && chosen[set] == col)
+               openings[col] |= OPEN_SOUTH;
+         }
+         for (int col = 0; col < numCol; ++col)
+         {
+            hasPassageDown[label[col]] = 0;
+            count[label[col]] = 0;
+         }
+      }
+
+      braidRow(row > 0 ? above.data() : NULL, openings.data(), isLastRow);
+      in_visit(row, openings.data());
+      above.swap(openings);
+   }
+}
+
+/******************************************************************************
+ * MAZE GENERATOR CARVE
+ * Opens the wall between two neighboring cells
+ ******************************************************************************/
+void MazeGenerator::carve(vector<unsigned char> & io_cells, int in_from,
+                          int in_to)
+{
+   // up and down first, since with one column the cell below is also
+   // the next one
+   if (in_to == in_from + m_numCol)
+      io_cells[in_from] |= OPEN_SOUTH;
+   else if (in_to == in_from - m_numCol)
+      io_cells[in_to] |= OPEN_SOUTH;
+   else if (in_to == in_from + 1)
+      io_cells[in_from] |= OPEN_EAST;
+   else
+   {
+      assert(in_to == in_from - 1);
+      io_cells[in_to] |= OPEN_EAST;
+   }
+}
+
+/******************************************************************************
+ * MAZE GENERATOR BRAID ROW
+ * Opens one more wall, east, west or south, at the braid's share of the
+ * dead ends in io_row. in_above is the row before, already handed out, or
+ * NULL for the first row; its walls can no longer change.
+ ******************************************************************************/
+void MazeGenerator::braidRow(const unsigned char * in_above,
+                             unsigned char * io_row, bool in_isLastRow)
+{
+   if (m_braid == 0)
+      return;
+
+   for (int col = 0; col < m_numCol; ++col)
+   {
+      bool isWestOpen = col > 0 && (io_row[col - 1] & OPEN_EAST);
+      bool isEastOpen = (io_row[col] & OPEN_EAST) != 0;
+      int numOpen = isWestOpen + isEastOpen +
+         ((io_row[col] & OPEN_SOUTH) != 0) +
+         (in_above != NULL && (in_above[col] & OPEN_SOUTH) != 0);
+      if (numOpen != 1 || random(65536) >= m_braid)
+         continue;
+
+      int options[3];
+      int numOptions = 0;
+      if (col + 1 < m_numCol && !isEastOpen)
+         options[numOptions++] = MAZE_EAST;
+      if (!in_isLastRow && !(io_row[col] & OPEN_SOUTH))
+         options[numOptions++] = MAZE_SOUTH;
+      if (col > 0 && !isWestOpen)
+         options[numOptions++] = MAZE_WEST;
+      if (numOptions == 0)
+         continue;
+
+      switch (options[random(numOptions)])
+      {
+         case MAZE_EAST:
+            io_row[col] |= OPEN_EAST;
+            break;
+         case MAZE_SOUTH:
+            io_row[col] |= OPEN_SOUTH;
+            break;
+         default:
+            io_row[col - 1] |= OPEN_EAST;
+      }
+   }
+}
+
+/******************************************************************************
+ * MAZE GENERATOR COIN
+ * A random true or false, taken a bit at a time from one random number
+ ******************************************************************************/
+bool MazeGenerator::coin()
+{
+   if (m_numCoins == 0)
+   {
+      m_coins = random(0xffffffffU);
+      m_numCoins = 31;
+   }
+   m_numCoins--;
+   bool isHeads = m_coins & 1;
+   m_coins >>= 1;
+   return isHeads;
+}
+
+/******************************************************************************
+ * MAZE GENERATOR RANDOM
+ * A random number from 0 up to in_bound, from a xorshift64* generator, so
+ * the same seed gives the same maze whatever the standard library
+ ******************************************************************************/
+unsigned int MazeGenerator::random(unsigned int in_bound)
+{
+   m_state ^= m_state >> 12;
+   m_state ^= m_state << 25;
+   m_state ^= m_state >> 27;
+   unsigned long long bits = (m_state * 0x2545f4914f6cdd1dULL) >> 32;
+   return (unsigned int)((bits * in_bound) >> 32);
+}
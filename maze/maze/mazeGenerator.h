@@ -0,0 +1,80 @@
+/***********************************************************************
+* Component:
+*    Week 13, Maze Generator
+* Author:
+*    Matthew Burr
+* Summary:
+*    Generates random rectangular mazes, perfect or braided, straight
+*    into a Graph, an edge list or the text maze format
+************************************************************************/
+
+#ifndef MAZEGENERATOR_H
+#define MAZEGENERATOR_H
+
+#include "graph.h"
+#include "gridGraph.h"
+#include <functional>
+#include <vector>
+
+// how the passages of a maze are carved
+enum MazeAlgorithm
+{
+   MAZE_BACKTRACKER,       // depth-first: long winding corridors
+   MAZE_KRUSKAL,           // random walls joined by union-find: short dead ends
+   MAZE_WILSON,            // loop-erased random walks: uniform over all mazes
+   MAZE_ELLER              // one row at a time, in O(width) memory
+};
+
+// called with each row of a maze, top to bottom: the row's index and the
+// OPEN_EAST and OPEN_SOUTH bits of its cells, valid only during the call
+typedef std::function<void(int, const unsigned char *)> MazeRowVisitor;
+
+/******************************************************************************
+ * MAZE GENERATOR
+ * Makes in_numCol by in_numRow mazes. A perfect maze has exactly one path
+ * between any two cells; setBraid() then opens a wall at that share of its
+ * dead ends, giving loops and more than one way through. The same seed,
+ * size, braid and algorithm always give the same maze, on any machine.
+ * Every maze comes out as rows of passage bits. Eller's algorithm makes
+ * them one at a time and keeps only the row it is on, so a maze of any
+ * height written through generate(algorithm, visitor) or write() takes
+ * O(width) memory; the others carve the whole grid, a byte a cell, first.
+ * A passage can be walked either way, so the edge list and the text file
+ * hold both directions of each one.
+ ******************************************************************************/
+class MazeGenerator
+{
+public:
+   MazeGenerator(int in_numCol, int in_numRow, unsigned int in_seed);
+
+   void setBraid(double in_fraction);
+   int numCol() const { return m_numCol; }
+   int numRow() const { return m_numRow; }
+
+   void generate(MazeAlgorithm in_algorithm, const MazeRowVisitor & in_visit);
+   void generate(MazeAlgorithm in_algorithm, std::vector<Edge> & out_edges);
+   Graph generate(MazeAlgorithm in_algorithm);
+   bool write(MazeAlgorithm in_algorithm, const char * in_fileName);
+
+private:
+   void backtracker(std::vector<unsigned char> & out_cells);
+   void kruskal(std::vector<unsigned char> & out_cells);
+   void wilson(std::vector<unsigned char> & out_cells);
+   void eller(const MazeRowVisitor & in_visit);
+   void carve(std::vector<unsigned char> & io_cells, int in_from, int in_to);
+   void braidRow(const unsigned char * in_above, unsigned char * io_row,
+                 bool in_isLastRow);
+   unsigned int random(unsigned int in_bound);
+   bool coin();
+
+   int m_numCol;
+   int m_numRow;
+   unsigned int m_seed;
+   unsigned int m_braid;           // dead ends opened, out of 65536
+   unsigned long long m_state;     // the random numbers, reset from m_seed
+                                   // by every generate()
+   unsigned int m_coins;           // random bits coin() hasn't used yet
+   int m_numCoins;
+};
+
+#endif // MAZEGENERATOR_H
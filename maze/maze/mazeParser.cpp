@@ -0,0 +1,217 @@
+/***********************************************************************
+* Component:
+*    Week 13, Maze Parser
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the MazeParser class
+************************************************************************/
+
+#include "mazeParser.h"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+using namespace std;
+
+// the blanks between tokens, spaces, tabs and line ends, as a bit apiece
+#define BLANKS ((1ull << ' ') | (1ull << '\t') | (1ull << '\r') | \
+                (1ull << '\n'))
+
+static inline bool isBlank(char in_c)
+{
+   return (unsigned char)in_c <= ' ' && ((BLANKS >> in_c) & 1);
+}
+
+// move in_p past spaces, tabs and line ends
+static inline const char * skipBlanks(const char * in_p, const char * in_end)
+{
+   while (in_p < in_end && isBlank(*in_p))
+      ++in_p;
+   return in_p;
+}
+
+// read one coordinate at io_p as a vertex index, returning what is wrong
+// with it, or NULL. It reads as parseCoordinate() does, letters counting
+// from a = 1, but keeps the column one less as it goes.
+static inline const char * scanVertex(const char * & io_p, const char * in_end,
+                                      int in_numCol, int in_numRow,
+                                      int & out_index)
+{
+   const char * p = io_p;
+   unsigned long long col = (unsigned char)(*p - 'a');
+   if (col >= 26)
+      return "expected a column letter";
+   for (++p; p < in_end && (unsigned char)(*p - 'a') < 26; ++p)
+   {
+      col = col * 26 + 26 + (unsigned char)(*p - 'a');
+      if (col >= INT_MAX)
+         return "malformed coordinate";
+   }
+
+   const char * digits = p;
+   unsigned long long row = 0;
+   for (; p < in_end && (unsigned char)(*p - '0') < 10; ++p)
+   {
+      row = row * 10 + (unsigned char)(*p - '0');
+      if (row > INT_MAX)
+         return "malformed coordinate";
+   }
+   if (p == digits || row == 0)
+      return "malformed coordinate";
+   io_p = p;
+   if (p < in_end && *p > ' ')
+      return "unexpected character in coordinate";
+   if (col >= (unsigned)in_numCol || row > (unsigned)in_numRow)
+      return "coordinate is outside the maze";
+
+   out_index = (int)(row - 1) * in_numCol + (int)col;
+   return NULL;
+}
+
+/******************************************************************************
+ * MAZE PARSER CONSTRUCTOR
+ * Prepares to parse the text from in_begin up to in_end
+ ******************************************************************************/
+MazeParser::MazeParser(const char * in_begin, const char * in_end)
+   : m_p(in_begin), m_end(in_end), m_pieceStart(in_begin), m_pieceLine(1),
+     m_numCol(0), m_numRow(0)
+{
+   m_error.line = 0;
+   m_error.column = 0;
+   m_error.message = 0;
+}
+
+/******************************************************************************
+ * MAZE PARSER READ SIZE
+ * Reads the number of columns and rows at the start of the maze
+ ******************************************************************************/
+bool MazeParser::readSize(int & out_numCol, int & out_numRow)
+{
+   if (!readNumber(m_numCol) || !readNumber(m_numRow))
+      return false;
+   if (m_numRow > INT_MAX / m_numCol)
+      return fail(m_p, "maze has too many cells");
+
+   out_numCol = m_numCol;
+   out_numRow = m_numRow;
+   return true;
+}
+
+/******************************************************************************
+ * MAZE PARSER READ EDGE
+ * Reads the next pair of coordinates as vertex indices. Returns false at
+ * the end of the text or at the first malformed token. The position is
+ * kept in locals while the pair is read and stored once at the end: the
+ * text is read through a char pointer, which may alias the members, so
+ * using them directly would store and reload them at every character.
+ * Lines aren't counted here; fail() works out where an error is.
+ ******************************************************************************/
+bool MazeParser::readEdge(int & out_from, int & out_to)
+{
+   assert(m_numCol > 0 && m_numRow > 0);
+   if (failed())
+      return false;
+
+   const char * p = m_p;
+   const char * end = m_end;
+   int numCol = m_numCol;
+   int numRow = m_numRow;
+   int from = 0;
+   int to = 0;
+
+   p = skipBlanks(p, end);
+   bool isEnd = p == end;
+   const char * token = p;
+   const char * message = NULL;
+   if (!isEnd)
+   {
+      message = scanVertex(p, end, numCol, numRow, from);
+      if (message == NULL)
+      {
+         p = skipBlanks(p, end);
+         token = p;
+         if (p == end)
+            message = "expected a second coordinate";
+         else
+            message = scanVertex(p, end, numCol, numRow, to);
+      }
+   }
+
+   m_p = p;
+   if (isEnd)
+      return false;
+   if (message != NULL)
+      return fail(token, message);
+   out_from = from;
+   out_to = to;
+   return true;
+}
+
+/******************************************************************************
+ * MAZE PARSER RESUME
+ * Carries on parsing in the next piece of the text, from in_begin up to
+ * in_end, which starts a new line. The size and line count carry over.
+ ******************************************************************************/
+void MazeParser::resume(const char * in_begin, const char * in_end)
+{
+   assert(!failed());
+   m_pieceLine += (int)count(m_pieceStart, m_end, '\n');
+   m_p = in_begin;
+   m_end = in_end;
+   m_pieceStart = in_begin;
+}
+
+/******************************************************************************
+ * MAZE PARSER SKIP SPACE
+ * Moves past any whitespace. Returns false at the end.
+ ******************************************************************************/
+bool MazeParser::skipSpace()
+{
+   m_p = skipBlanks(m_p, m_end);
+   return m_p < m_end;
+}
+
+/******************************************************************************
+ * MAZE PARSER READ NUMBER
+ * Reads a positive whole number
+ ******************************************************************************/
+bool MazeParser::readNumber(int & out_value)
+{
+   if (!skipSpace())
+      return fail(m_p, "expected the size of the maze");
+
+   const char * start = m_p;
+   int value = 0;
+   while (m_p < m_end && *m_p >= '0' && *m_p <= '9')
+   {
+      if (value > (INT_MAX - 9) / 10)
+         return fail(start, "maze size is too large");
+      value = value * 10 + (*m_p++ - '0');
+   }
+
+   if (m_p == start || value == 0 || (m_p < m_end && *m_p > ' '))
+      return fail(start, "expected the size of the maze");
+
+   out_value = value;
+   return true;
+}
+
+/******************************************************************************
+ * MAZE PARSER FAIL
+ * Records an error at the token starting at in_tokenStart, counting the
+ * lines of the piece up to it to find its line and column
+ ******************************************************************************/
+bool MazeParser::fail(const char * in_tokenStart, const char * in_message)
+{
+   const char * lineStart = m_pieceStart;
+   m_error.line = m_pieceLine;
+   for (const char * p = m_pieceStart; p < in_tokenStart; ++p)
+      if (*p == '\n')
+      {
+         m_error.line++;
+         lineStart = p + 1;
+      }
+   m_error.column = (int)(in_tokenStart - lineStart) + 1;
+   m_error.message = in_message;
+   return false;
+}
@@ -0,0 +1,59 @@
+/***********************************************************************
+* Component:
+*    Week 13, Maze Parser
+* Author:
+*    Matthew Burr
+* Summary:
+*    Reads the text maze format straight out of memory: the number of
+*    columns and rows, then pairs of coordinates such as "a1 a2"
+************************************************************************/
+
+#ifndef MAZEPARSER_H
+#define MAZEPARSER_H
+
+/******************************************************************************
+ * PARSE ERROR
+ * Where the text stopped making sense, and why
+ ******************************************************************************/
+struct ParseError
+{
+   int line;              // 1 based
+   int column;            // 1 based
+   const char * message;
+};
+
+/******************************************************************************
+ * MAZE PARSER
+ * Tokenizes a maze held in memory without copying it. Call readSize() once,
+ * then readEdge() until it returns false; failed() then tells whether the
+ * text ended cleanly or at a malformed token, which error() describes.
+ * Text read a piece at a time is handed over with resume(), each piece
+ * ending at the end of a line, so no token is ever split between two.
+ ******************************************************************************/
+class MazeParser
+{
+public:
+   MazeParser(const char * in_begin, const char * in_end);
+
+   bool readSize(int & out_numCol, int & out_numRow);
+   bool readEdge(int & out_from, int & out_to);
+   void resume(const char * in_begin, const char * in_end);
+
+   bool failed() const { return m_error.message != 0; }
+   const ParseError & error() const { return m_error; }
+
+private:
+   bool skipSpace();
+   bool readNumber(int & out_value);
+   bool fail(const char * in_tokenStart, const char * in_message);
+
+   const char * m_p;
+   const char * m_end;
+   const char * m_pieceStart;   // where the piece being parsed begins
+   int m_pieceLine;             // and the line it begins on
+   int m_numCol;
+   int m_numRow;
+   ParseError m_error;
+};
+
+#endif // MAZEPARSER_H
@@ -0,0 +1,262 @@
+/***********************************************************************
+* Component:
+*    Week 13, Parallel BFS
+* Author:
+*    Matthew Burr
+* Summary:
+*    A direction-optimizing breadth-first search: each level either
+*    expands the frontier (top-down) or has every unvisited vertex look
+*    for a parent in the frontier (bottom-up), whichever checks fewer edges
+************************************************************************/
+
+#include "parallelBfs.h"
+#include <atomic>
+#include <cassert>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using namespace std;
+
+// switch to bottom-up once the frontier's edges are more than 1/BFS_ALPHA
+// of the edges still unexplored, and back to top-down once the frontier
+// is shrinking and holds fewer than 1/BFS_BETA of the vertices
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+// tasks each level is split into, per thread, so that idle threads can
+// steal from busy ones
+#define BFS_TASKS_PER_THREAD 4
+
+// below this many vertices the threads cost more than they save
+#define BFS_PARALLEL_MIN 4096
+
+// the bottom-up frontier is a bitset, a word of vertices at a time
+typedef unsigned long long BfsWord;
+#define BFS_WORD_BITS 64
+
+// the position of the lowest set bit of in_word, which is not zero
+static inline int lowestBit(BfsWord in_word)
+{
+   assert(in_word != 0);
+#if defined(__GNUC__)
+   return __builtin_ctzll(in_word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+   unsigned long position;
+   _BitScanForward64(&position, in_word);
+   return (int)position;
+#else
+   int position = 0;
+   while (!(in_word & 1))
+   {
+      in_word >>= 1;
+      position++;
+   }
+   return position;
+#endif
+}
+
+/******************************************************************************
+ * PARALLEL FOR
+ * Splits 0 up to in_count into at most in_numTasks ranges, runs
+ * in_body(task, first, last) for each on in_pool, and waits for them all
+ ******************************************************************************/
+template <class Body>
+static void parallelFor(ThreadPool & in_pool, int in_count, int in_numTasks,
+                        Body in_body)
+{
+   int perTask = (in_count + in_numTasks - 1) / in_numTasks;
+   if (perTask == 0)
+      perTask = 1;
+
+   int task = 0;
+   for (int first = 0; first < in_count; first += perTask, task++)
+   {
+      int last = first + perTask < in_count ? first + perTask : in_count;
+      in_pool.submit([&in_body, task, first, last](int worker)
+      {
+         in_body(task, first, last);
+      });
+   }
+   in_pool.wait();
+}
+
+/******************************************************************************
+ * FIND PATH PARALLEL
+ * Level-synchronous breadth-first search. Every vertex found at a level has
+ * its parent at the level before, so the first level that reaches in_end
+ * gives a shortest path.
+ *
+ * Top-down, the frontier is a list split among the tasks, and a vertex is
+ * claimed by whichever task first swaps its parent from -1. Bottom-up, the
+ * frontier is a bitmap, each task owns a run of 64-vertex words, and each
+ * unvisited vertex in the run walks its incoming edges (the reverse CSR)
+ * until it finds a parent in the frontier. Once the frontier covers much of
+ * the graph that second way stops after one or two edges per vertex
+ * instead of checking every edge out of the frontier.
+ *
+ * Needs the reverse CSR, so a Graph that isn't frozen, like a small one,
+ * is searched with Graph::findPath instead.
+ ******************************************************************************/
+vector<Vertex> findPathParallel(const Graph & in_graph,
+                                const Vertex & in_start,
+                                const Vertex & in_end,
+                                ThreadPool & in_pool,
+                                int & out_expanded)
+{
+   assert(in_start.index() >= 0 && in_start.index() < in_graph.size());
+   assert(in_end.index() >= 0 && in_end.index() < in_graph.size());
+
+   if (!in_graph.isFrozen() || in_graph.size() < BFS_PARALLEL_MIN)
+      return in_graph.findPath(in_start, in_end, SEARCH_FORWARD, out_expanded);
+
+   CsrArrays csr = in_graph.csr();
+   int numVertices = in_graph.size();
+   int numWords = (numVertices + BFS_WORD_BITS - 1) / BFS_WORD_BITS;
+   int numTasks = in_pool.size() * BFS_TASKS_PER_THREAD;
+   int start = in_start.index();
+   int goal = in_end.index();
+
+   vector< atomic<int> > parent(numVertices);
+   parallelFor(in_pool, numVertices, numTasks, [&](int task, int first, int last)
+   {
+      for (int v = first; v < last; ++v)
+         parent[v].store(-1, memory_order_relaxed);
+   });
+   parent[start].store(start, memory_order_relaxed);
+
+   vector<VertexId> frontier(1, start);          // top-down frontier
+   vector<BfsWord> current;                       // bottom-up frontier
+   vector<BfsWord> next;
+   vector< vector<VertexId> > found(numTasks);
+   vector<long long> foundEdges(numTasks);
+   vector<int> foundCount(numTasks);
+   atomic<int> expanded(0);
+
+   bool isBottomUp = false;
+   bool isGrowing = true;
+   int frontierSize = 1;
+   long long frontierEdges = csr.offsets[start + 1] - csr.offsets[start];
+   long long unexploredEdges = csr.offsets[numVertices] - frontierEdges;
+
+   while (frontierSize > 0 && parent[goal].load(memory_order_relaxed) == -1)
+   {
+      int previousSize = frontierSize;
+
+      // pick the direction for this level, converting the frontier to suit
+      if (!isBottomUp && frontierEdges > unexploredEdges / BFS_ALPHA)
+      {
+         current.assign(numWords, 0);
+         for (size_t i = 0; i < frontier.size(); ++i)
+            current[frontier[i] / BFS_WORD_BITS] |=
+               (BfsWord)1 << (frontier[i] % BFS_WORD_BITS);
+         next.assign(numWords, 0);
+         isBottomUp = true;
+      }
+      else if (isBottomUp && !isGrowing && frontierSize < numVertices / BFS_BETA)
+      {
+         frontier.clear();
+         for (int w = 0; w < numWords; ++w)
+            for (BfsWord bits = current[w]; bits; bits &= bits - 1)
+               frontier.push_back(w * BFS_WORD_BITS + lowestBit(bits));
+         isBottomUp = false;
+      }
+
+      if (isBottomUp)
+      {
+         parallelFor(in_pool, numWords, numTasks, [&](int task, int first, int last)
+         {
+            int count = 0;
+            int checked = 0;
+            long long edges = 0;
+            for (int w = first; w < last; ++w)
+            {
+               BfsWord bits = 0;
+               int end = (w + 1) * BFS_WORD_BITS;
+               if (end > numVertices)
+                  end = numVertices;
+               for (int v = w * BFS_WORD_BITS; v < end; ++v)
+               {
+                  if (parent[v].load(memory_order_relaxed) != -1)
+                     continue;
+                  checked++;
+                  for (int j = csr.revOffsets[v]; j < csr.revOffsets[v + 1]; ++j)
+                  {
+                     int u = csr.revNeighbors[j];
+                     if ((current[u / BFS_WORD_BITS] >>
+                          (u % BFS_WORD_BITS)) & 1)
+                     {
+                        parent[v].store(u, memory_order_relaxed);
+                        bits |= (BfsWord)1 << (v % BFS_WORD_BITS);
+                        count++;
+                        edges += csr.offsets[v + 1] - csr.offsets[v];
+                        break;
+                     }
+                  }
+               }
+               next[w] = bits;
+            }
+            foundCount[task] = count;
+            foundEdges[task] = edges;
+            expanded += checked;
+         });
+         current.swap(next);
+      }
+      else
+      {
+         parallelFor(in_pool, (int)frontier.size(), numTasks,
+                     [&](int task, int first, int last)
+         {
+            vector<VertexId> & mine = found[task];
+            long long edges = 0;
+            mine.clear();
+            for (int i = first; i < last; ++i)
+            {
+               int v = frontier[i];
+               for (int j = csr.offsets[v]; j < csr.offsets[v + 1]; ++j)
+               {
+                  int w = csr.neighbors[j];
+                  int unclaimed = -1;
+                  if (parent[w].load(memory_order_relaxed) == -1 &&
+                      parent[w].compare_exchange_strong(unclaimed, v,
+                                                        memory_order_relaxed))
+                  {
+                     mine.push_back(w);
+                     edges += csr.offsets[w + 1] - csr.offsets[w];
+                  }
+               }
+            }
+            foundCount[task] = (int)mine.size();
+            foundEdges[task] = edges;
+            expanded += last - first;
+         });
+
+         frontier.clear();
+         for (int t = 0; t < numTasks; ++t)
+            if (foundCount[t])
+               frontier.insert(frontier.end(), found[t].begin(), found[t].end());
+      }
+
+      // tally the new frontier; tasks that had no range left reported nothing
+      frontierSize = 0;
+      frontierEdges = 0;
+      for (int t = 0; t < numTasks; ++t)
+      {
+         frontierSize += foundCount[t];
+         frontierEdges += foundEdges[t];
+         foundCount[t] = 0;
+         foundEdges[t] = 0;
+      }
+      unexploredEdges -= frontierEdges;
+      isGrowing = frontierSize > previousSize;
+   }
+
+   out_expanded = expanded;
+   if (parent[goal].load(memory_order_relaxed) == -1)
+      throw "ERROR: No path from source to destination.";
+
+   vector<Vertex> path;
+   for (int v = goal; v != start; v = parent[v].load(memory_order_relaxed))
+      path.push_back(Vertex::fromIndex(v));
+   path.push_back(in_start);
+   return path;
+}
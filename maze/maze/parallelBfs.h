@@ -0,0 +1,29 @@
+/***********************************************************************
+* Component:
+*    Week 13, Parallel BFS
+* Author:
+*    Matthew Burr
+* Summary:
+*    Finds one shortest path through a very large Graph with a
+*    breadth-first search spread across many threads
+************************************************************************/
+
+#ifndef PARALLELBFS_H
+#define PARALLELBFS_H
+
+#include "graph.h"
+#include "threadPool.h"
+#include "vertex.h"
+#include <vector>
+
+// the shortest path from in_start to in_end, searched level by level on
+// in_pool's threads. Like Graph::findPath, the path runs from in_end back to
+// in_start, out_expanded receives the number of vertices expanded, and
+// there being no path throws.
+std::vector<Vertex> findPathParallel(const Graph & in_graph,
+                                     const Vertex & in_start,
+                                     const Vertex & in_end,
+                                     ThreadPool & in_pool,
+                                     int & out_expanded);
+
+#endif // PARALLELBFS_H
@@ -0,0 +1,90 @@
+/***********************************************************************
+* Component:
+*    Week 13, Path Cache
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the PathCache class
+************************************************************************/
+
+#include "pathCache.h"
+using namespace std;
+
+// the memory one tree takes
+static size_t treeBytes(const PredecessorTree & in_tree)
+{
+   return in_tree.size() * sizeof(VertexId);
+}
+
+/******************************************************************************
+ * PATH CACHE FIND
+ * Returns the tree for in_source, marking it most recently used, or an
+ * empty pointer if it isn't cached
+ ******************************************************************************/
+PredecessorTreePtr PathCache::find(int in_source)
+{
+   lock_guard<mutex> guard(m_lock);
+
+   unordered_map<int, list<Entry>::iterator>::iterator it = m_index.find(in_source);
+   if (it == m_index.end())
+   {
+      m_misses++;
+      return PredecessorTreePtr();
+   }
+
+   m_hits++;
+   m_entries.splice(m_entries.begin(), m_entries, it->second);
+   return it->second->tree;
+}
+
+/******************************************************************************
+ * PATH CACHE INSERT
+ * Keeps in_tree as the tree for in_source, dropping the least recently used
+ * trees until it fits. Two threads that missed on the same source may both
+ * insert it; the second is ignored.
+ ******************************************************************************/
+void PathCache::insert(int in_source, const PredecessorTreePtr & in_tree)
+{
+   size_t bytes = treeBytes(*in_tree);
+   lock_guard<mutex> guard(m_lock);
+
+   if (bytes > m_budget || m_index.count(in_source))
+      return;
+
+   while (m_bytes + bytes > m_budget)
+   {
+      m_bytes -= treeBytes(*m_entries.back().tree);
+      m_index.erase(m_entries.back().source);
+      m_entries.pop_back();
+   }
+
+   Entry entry = { in_source, in_tree };
+   m_entries.push_front(entry);
+   m_index[in_source] = m_entries.begin();
+   m_bytes += bytes;
+}
+
+/******************************************************************************
+ * PATH CACHE CLEAR
+ * Drops every tree, as when the graph they were built from changes. The
+ * hit and miss counts carry on.
+ ******************************************************************************/
+void PathCache::clear()
+{
+   lock_guard<mutex> guard(m_lock);
+   m_entries.clear();
+   m_index.clear();
+   m_bytes = 0;
+}
+
+/******************************************************************************
+ * PATH CACHE STATS
+ * The counters and sizes, all read at one moment
+ ******************************************************************************/
+PathCacheStats PathCache::stats() const
+{
+   lock_guard<mutex> guard(m_lock);
+   PathCacheStats stats = { m_hits, m_misses, (int)m_entries.size(),
+                            m_bytes, m_budget };
+   return stats;
+}
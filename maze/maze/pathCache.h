@@ -0,0 +1,79 @@
+/***********************************************************************
+* Component:
+*    Week 13, Path Cache
+* Author:
+*    Matthew Burr
+* Summary:
+*    Keeps the shortest-path trees of recently used sources so that
+*    repeated queries from the same source just walk a tree
+************************************************************************/
+
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "vertex.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// every vertex's predecessor on a shortest path from one source; -1 for
+// vertices that can't be reached, and the source itself for the source
+typedef std::vector<VertexId> PredecessorTree;
+typedef std::shared_ptr<const PredecessorTree> PredecessorTreePtr;
+
+/******************************************************************************
+ * PATH CACHE STATS
+ * How a PathCache has done
+ ******************************************************************************/
+struct PathCacheStats
+{
+   int hits;          // lookups that found their source's tree
+   int misses;        // lookups that had to build it
+   int trees;         // trees held now
+   size_t bytes;      // memory those trees take
+   size_t budget;     // the most memory they may take
+};
+
+/******************************************************************************
+ * PATH CACHE
+ * Predecessor trees keyed by source, within a budget of bytes. When a new
+ * tree would go over the budget, the least recently used trees are dropped
+ * to make room; a tree bigger than the whole budget is never kept. Trees are
+ * shared, so one being walked by a thread stays alive even if another
+ * thread drops it from the cache. Safe to use from many threads at once.
+ ******************************************************************************/
+class PathCache
+{
+public:
+   PathCache(size_t in_budget) : m_budget(in_budget), m_bytes(0),
+                                 m_hits(0), m_misses(0) {}
+
+   PredecessorTreePtr find(int in_source);
+   void insert(int in_source, const PredecessorTreePtr & in_tree);
+   void clear();
+   PathCacheStats stats() const;
+   size_t budget() const { return m_budget; }
+
+private:
+   PathCache(const PathCache &);
+   PathCache & operator = (const PathCache &);
+
+   struct Entry
+   {
+      int source;
+      PredecessorTreePtr tree;
+   };
+
+   mutable std::mutex m_lock;       // guards everything below
+   std::list<Entry> m_entries;      // most recently used first
+   std::unordered_map<int, std::list<Entry>::iterator> m_index;
+   size_t m_budget;
+   size_t m_bytes;
+   int m_hits;
+   int m_misses;
+};
+
+#endif // PATHCACHE_H
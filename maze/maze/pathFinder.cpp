@@ -0,0 +1,155 @@
+/***********************************************************************
+* Component:
+*    Week 13, Path Finder
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the PathFinder class
+************************************************************************/
+
+#include "pathFinder.h"
+#include <cassert>
+using namespace std;
+
+/******************************************************************************
+ * PATH FINDER CONSTRUCTOR
+ * Binds a new PathFinder to in_graph and sizes its buffers once
+ ******************************************************************************/
+PathFinder::PathFinder(const Graph & in_graph)
+   : m_graph(&in_graph),
+     m_grid(NULL),
+     m_stamp(in_graph.size(), 0),
+     m_distance(in_graph.size()),
+     m_predecessor(in_graph.size()),
+     m_generation(0),
+     m_expanded(0)
+{
+   m_queue.reserve(in_graph.size());
+}
+
+/******************************************************************************
+ * PATH FINDER CONSTRUCTOR
+ * Binds a new PathFinder to the grid maze in_graph
+ ******************************************************************************/
+PathFinder::PathFinder(const GridGraph & in_graph)
+   : m_graph(NULL),
+     m_grid(&in_graph),
+     m_stamp(in_graph.size(), 0),
+     m_distance(in_graph.size()),
+     m_predecessor(in_graph.size()),
+     m_generation(0),
+     m_expanded(0)
+{
+   m_queue.reserve(in_graph.size());
+}
+
+/******************************************************************************
+ * PATH FINDER FIND PATH
+ * Finds the shortest path from in_start to in_end. Like Graph::findPath, the
+ * path runs from in_end back to in_start, and an exception is thrown if
+ * there is no path.
+ ******************************************************************************/
+vector<Vertex> PathFinder::findPath(const Vertex & in_start, const Vertex & in_end)
+{
+   if (!search(in_start.index(), in_end.index()))
+      throw "ERROR: No path from source to destination.";
+
+   vector<Vertex> path;
+   tracePath(in_start.index(), in_end.index(), path);
+   return path;
+}
+
+/******************************************************************************
+ * PATH FINDER FIND PATHS
+ * Answers a batch of (start, end) queries, filling out_paths with one path
+ * per query in the same order. A query with no path gets an empty path.
+ ******************************************************************************/
+void PathFinder::findPaths(const vector<PathQuery> & in_queries,
+                           vector< vector<Vertex> > & out_paths)
+{
+   out_paths.resize(in_queries.size());
+   for (size_t i = 0; i < in_queries.size(); ++i)
+   {
+      int start = in_queries[i].first.index();
+      int end = in_queries[i].second.index();
+
+      out_paths[i].clear();
+      if (search(start, end))
+         tracePath(start, end, out_paths[i]);
+   }
+}
+
+/******************************************************************************
+ * PATH FINDER SEARCH
+ * Breadth-first search from in_start until in_end is reached. Returns false
+ * if in_end can't be reached.
+ ******************************************************************************/
+bool PathFinder::search(int in_start, int in_end)
+{
+   assert(in_start >= 0 && in_start < (int)m_stamp.size());
+   assert(in_end >= 0 && in_end < (int)m_stamp.size());
+
+   // a new generation makes every vertex unvisited; when the counter wraps
+   // around, old stamps could look current again, so clear them for real
+   if (++m_generation == 0)
+   {
+      m_stamp.assign(m_stamp.size(), 0);
+      m_generation = 1;
+   }
+
+   m_queue.clear();
+   m_expanded = 0;
+
+   m_stamp[in_start] = m_generation;
+   m_distance[in_start] = 0;
+   m_predecessor[in_start] = -1;
+   m_queue.push_back(in_start);
+
+   if (m_graph != NULL)
+      expand(*m_graph, in_end);
+   else
+      expand(*m_grid, in_end);
+
+   return isVisited(in_end);
+}
+
+/******************************************************************************
+ * PATH FINDER EXPAND
+ * Visits the queued vertices in order, queueing their unvisited neighbors,
+ * until in_end has been reached
+ ******************************************************************************/
+template <class G>
+void PathFinder::expand(const G & in_graph, int in_end)
+{
+   for (size_t head = 0; head < m_queue.size() && !isVisited(in_end); ++head)
+   {
+      int v = m_queue[head];
+      m_expanded++;
+
+      in_graph.forEachNeighbor(v, [&](int next)
+      {
+         if (!isVisited(next))
+         {
+            m_stamp[next] = m_generation;
+            m_distance[next] = m_distance[v] + 1;
+            m_predecessor[next] = v;
+            m_queue.push_back(next);
+         }
+      });
+   }
+}
+
+/******************************************************************************
+ * PATH FINDER TRACE PATH
+ * Follows the predecessors of the last search from in_end back to in_start
+ ******************************************************************************/
+void PathFinder::tracePath(int in_start, int in_end, vector<Vertex> & out_path) const
+{
+   assert(isVisited(in_end));
+
+   out_path.reserve(m_distance[in_end] + 1);
+   for (int v = in_end; v != -1; v = m_predecessor[v])
+      out_path.push_back(Vertex::fromIndex(v));
+
+   assert(out_path.back().index() == in_start);
+}
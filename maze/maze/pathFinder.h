@@ -0,0 +1,61 @@
+/***********************************************************************
+* Component:
+*    Week 13, Path Finder
+* Author:
+*    Matthew Burr
+* Summary:
+*    A reusable breadth-first search context for answering many path
+*    queries against the same Graph
+************************************************************************/
+
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include "graph.h"
+#include "gridGraph.h"
+#include "vertex.h"
+#include <vector>
+#include <utility>
+
+typedef std::pair<Vertex, Vertex> PathQuery;
+
+/******************************************************************************
+ * PATH FINDER
+ * Finds shortest paths in one Graph or GridGraph, keeping its search buffers
+ * from one query to the next. Rather than clearing the buffers before every
+ * search, each entry is stamped with the generation of the search that wrote
+ * it, and entries with an older stamp are treated as unvisited. Starting a
+ * new search is then O(1), and a search only touches the vertices it reaches.
+ * The graph must not change while a PathFinder is bound to it.
+ ******************************************************************************/
+class PathFinder
+{
+public:
+   PathFinder(const Graph & in_graph);
+   PathFinder(const GridGraph & in_graph);
+
+   std::vector<Vertex> findPath(const Vertex & in_start, const Vertex & in_end);
+   void findPaths(const std::vector<PathQuery> & in_queries,
+                  std::vector< std::vector<Vertex> > & out_paths);
+
+   // number of vertices expanded by the last search
+   int expanded() const { return m_expanded; }
+
+private:
+   bool search(int in_start, int in_end);
+   template <class G>
+   void expand(const G & in_graph, int in_end);
+   void tracePath(int in_start, int in_end, std::vector<Vertex> & out_path) const;
+   bool isVisited(int in_vertex) const { return m_stamp[in_vertex] == m_generation; }
+
+   const Graph * m_graph;               // the graph searched: one of these
+   const GridGraph * m_grid;            // two is set, the other is NULL
+   std::vector<unsigned int> m_stamp;   // generation that last visited each vertex
+   std::vector<int> m_distance;         // distance from the start; valid if visited
+   std::vector<VertexId> m_predecessor; // previous vertex on the path; valid if visited
+   std::vector<VertexId> m_queue;       // vertices to visit, reused between searches
+   unsigned int m_generation;
+   int m_expanded;
+};
+
+#endif // PATHFINDER_H
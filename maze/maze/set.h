@@ -2,8 +2,13 @@
 #define SET_H
 
 #include <cassert>
+#include <algorithm>
 #include "setIterator.h"
 #include "setConstIterator.h"
+#include "setKernels.h"
+#include "arena.h"
+#include <new>
+#include <type_traits>
 
 template <class T>
 class Set
@@ -11,10 +16,12 @@ class Set
 public:
 
    // constructors/destructors
-   Set(int in_capacity = 0);
+   Set(int in_capacity = 0, Arena * in_arena = NULL);
    Set(const Set<T> & source);
+   Set(Set<T> && source);
    ~Set();
    Set<T> & operator = (const Set<T> & source);
+   Set<T> & operator = (Set<T> && source);
 
    // basic metadata
    int size() const { return m_size; }
@@ -24,6 +31,8 @@ public:
    // data management
    void clear() { m_size = 0; }
    void insert(const T & in_item);
+   template <class Iterator>
+   void assign(Iterator in_first, Iterator in_last);
    void erase(SetIterator<T> & in_location);
 
    // data access
@@ -32,6 +41,7 @@ public:
    SetIterator<T> end() const;
    SetConstIterator<T> cbegin() const { return SetConstIterator<T>(m_data); }
    SetConstIterator<T> cend() const { return SetConstIterator<T>(m_data + m_size); }
+   const T * data() const { return m_data; }
 
    // operations
    Set<T> operator && (const Set<T> & rhs) const;
@@ -54,16 +64,19 @@ private:
    int m_capacity;
    int m_size;
    T * m_data;
+   Arena * m_arena;     // where m_data comes from; the heap if NULL
 };
 
 /*************************************
 * SET :: CONSTRUCTOR
 * Creates a new instance of a Set with
-* an optional capacity
+* an optional capacity. If in_arena is
+* given, the set's buffers come from it
+* and are only freed with the arena.
 *************************************/
 template <class T>
-Set<T> ::Set(int in_capacity)
-   : m_capacity(in_capacity), m_size(0), m_data(NULL)
+Set<T> ::Set(int in_capacity, Arena * in_arena)
+   : m_capacity(in_capacity), m_size(0), m_data(NULL), m_arena(in_arena)
 {
    assert(m_capacity >= 0);
    if (m_capacity < 0)
@@ -78,11 +91,14 @@ Set<T> ::Set(int in_capacity)
 /*************************************
 * SET :: COPY CONSTRUCTOR
 * Creates a new instance of a Set
-* by copying an existing set
+* by copying an existing set. The copy
+* is always on the heap, so it can
+* outlive the original's arena.
 *************************************/
 template<class T>
 Set<T>::Set(const Set<T>& source)
-   : m_capacity(source.m_capacity), m_size(source.m_size), m_data(NULL)
+   : m_capacity(source.m_capacity), m_size(source.m_size), m_data(NULL),
+     m_arena(NULL)
 {
    assert(source.isValid());
 
@@ -91,6 +107,24 @@ Set<T>::Set(const Set<T>& source)
    assert(isValid());
 }
 
+/*************************************
+* SET :: MOVE CONSTRUCTOR
+* Creates a new instance of a Set by
+* taking over the buffer of a set that
+* is about to go away, leaving it empty
+*************************************/
+template<class T>
+Set<T>::Set(Set<T> && source)
+   : m_capacity(source.m_capacity), m_size(source.m_size), m_data(source.m_data),
+     m_arena(source.m_arena)
+{
+   source.m_capacity = 0;
+   source.m_size = 0;
+   source.m_data = NULL;
+
+   assert(isValid());
+}
+
 /*************************************
 * SET :: DESTRUCTOR
 * Destroys a set and deallocates its memory
@@ -122,6 +156,37 @@ inline Set<T>& Set<T>::operator=(const Set<T>& source)
    return *this;
 }
 
+/*************************************
+* SET :: MOVE ASSIGNMENT
+* Takes over the buffer of a set that
+* is about to go away, leaving it empty.
+* A buffer from a different arena (or
+* the heap) is copied instead, so this
+* set's memory stays in one place.
+*************************************/
+template<class T>
+inline Set<T>& Set<T>::operator=(Set<T> && source)
+{
+   if (this == &source)
+      return *this;
+
+   if (m_arena != source.m_arena)
+      return *this = (const Set<T> &)source;
+
+   deleteData();
+
+   m_capacity = source.m_capacity;
+   m_size = source.m_size;
+   m_data = source.m_data;
+   source.m_capacity = 0;
+   source.m_size = 0;
+   source.m_data = NULL;
+
+   assert(isValid());
+
+   return *this;
+}
+
 /*************************************
 * SET :: INSERT
 * Inserts an item into the set, if it
@@ -162,6 +227,45 @@ void Set<T> ::insert(const T & in_item)
    assert(isDataSorted());
 }
 
+/*************************************
+* SET :: ASSIGN
+* Replaces the contents of the set with
+* the items from in_first up to in_last,
+* in any order and with repeats. They
+* are sorted and the repeats dropped
+* once, rather than inserting one at a
+* time.
+*************************************/
+template<class T>
+template<class Iterator>
+void Set<T>::assign(Iterator in_first, Iterator in_last)
+{
+   int count = 0;
+   for (Iterator it = in_first; it != in_last; ++it)
+      count++;
+
+   if (count > m_capacity)
+   {
+      deleteData();
+      m_capacity = 0;
+      allocate(count);
+      m_capacity = count;
+   }
+
+   m_size = 0;
+   for (Iterator it = in_first; it != in_last; ++it)
+      m_data[m_size++] = *it;
+
+   if (m_size)
+   {
+      std::sort(m_data, m_data + m_size);
+      m_size = (int)(std::unique(m_data, m_data + m_size) - m_data);
+   }
+
+   assert(isValid());
+   assert(isDataSorted());
+}
+
 /*************************************
 * SET :: ERASE
 * Removes an item - specified by an
@@ -333,12 +437,21 @@ inline Set<T> Set<T>::operator-(const Set<T>& rhs) const
 
    Set<T> result;
 
-   int index = 0;
+   // a merge join, like the intersection, keeping what only this side has
+   int iSet1 = 0;
+   int iSet2 = 0;
 
-   for (int i = 0; i < m_size; i++)
+   while (iSet1 < m_size)
    {
-      if (!rhs.findIndex(m_data[i], index))
-         result.addToEnd(m_data[i]);
+      if (iSet2 == rhs.m_size || m_data[iSet1] < rhs.m_data[iSet2])
+         result.addToEnd(m_data[iSet1++]);
+      else if (rhs.m_data[iSet2] < m_data[iSet1])
+         iSet2++;
+      else
+      {
+         iSet1++;
+         iSet2++;
+      }
    }
 
    assert(result.isValid());
@@ -347,6 +460,42 @@ inline Set<T> Set<T>::operator-(const Set<T>& rhs) const
    return result;
 }
 
+/*************************************
+* SET <INT> :: INTERSECTION / UNION /
+* DIFFERENCE
+* Sets of ints (which includes sets of
+* VertexIds) hand the merge to the
+* kernels in setKernels.h, which use the
+* processor's vector instructions and
+* gallop when one side is much larger.
+*************************************/
+template<>
+inline Set<int> Set<int>::operator&&(const Set<int>& rhs) const
+{
+   Set<int> result(m_size < rhs.m_size ? m_size : rhs.m_size);
+   result.m_size = intersectSorted(m_data, m_size, rhs.m_data, rhs.m_size,
+                                   result.m_data);
+   return result;
+}
+
+template<>
+inline Set<int> Set<int>::operator||(const Set<int>& rhs) const
+{
+   Set<int> result(m_size + rhs.m_size);
+   result.m_size = uniteSorted(m_data, m_size, rhs.m_data, rhs.m_size,
+                               result.m_data);
+   return result;
+}
+
+template<>
+inline Set<int> Set<int>::operator-(const Set<int>& rhs) const
+{
+   Set<int> result(m_size);
+   result.m_size = subtractSorted(m_data, m_size, rhs.m_data, rhs.m_size,
+                                  result.m_data);
+   return result;
+}
+
 /*************************************
 * SET :: FINDINDEX
 * If it exists in the set, returns the
@@ -441,7 +590,10 @@ inline void Set<T>::deleteData()
 {
    if (m_data != NULL)
    {
-      delete[] m_data;
+      if (m_arena != NULL)
+         m_arena->deallocate(m_data, m_capacity * sizeof(T));
+      else
+         delete[] m_data;
       m_data = NULL;
    }
 }
@@ -493,14 +645,24 @@ inline void Set<T>::copyData(T * in_data)
 /*************************************
 * SET :: ALLOCATE
 * Creates a new data buffer with a given
-* capacity. Note: does not attempt to
+* capacity, from the set's arena if it
+* has one. Note: does not attempt to
 * deallocate an existing buffer; that
 * must be done separately.
 *************************************/
 template<class T>
 inline void Set<T>::allocate(int in_capacity)
 {
-   if (in_capacity)
+   if (in_capacity && m_arena != NULL)
+   {
+      // the arena never runs destructors
+      assert(std::is_trivially_destructible<T>::value);
+      m_data = static_cast<T *>(m_arena->allocate(in_capacity * sizeof(T),
+                                                  alignof(T)));
+      for (int i = 0; i < in_capacity; i++)
+         new (m_data + i) T();
+   }
+   else if (in_capacity)
    {
       try
       {
@@ -531,7 +693,10 @@ inline void Set<T>::resize()
    if (NULL != oldData)
    {
       copyData(oldData);
-      delete[] oldData;
+      if (m_arena != NULL)
+         m_arena->deallocate(oldData, m_capacity * sizeof(T));
+      else
+         delete[] oldData;
    }
 
    m_capacity = capacity;
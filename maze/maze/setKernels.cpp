@@ -0,0 +1,620 @@
+/***********************************************************************
+* Component:
+*    Week 13, Set Kernels
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the sorted array kernels behind Set<int>'s operators
+************************************************************************/
+
+#include "setKernels.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SET_KERNELS_X86
+#define SET_KERNELS_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SET_KERNELS_X86
+#define SET_KERNELS_TARGET(isa)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+typedef int (*SetKernel)(const int *, int, const int *, int, int *);
+
+/******************************************************************************
+ * INTERSECT / UNITE / SUBTRACT SCALAR
+ * The plain merge joins. The vector kernels use these to finish whatever is
+ * left over once fewer than a full vector remains on either side.
+ ******************************************************************************/
+static int intersectScalar(const int * in_a, int in_numA,
+                           const int * in_b, int in_numB, int * out_result)
+{
+   int i = 0;
+   int j = 0;
+   int num = 0;
+   while (i < in_numA && j < in_numB)
+   {
+      if (in_a[i] < in_b[j])
+         i++;
+      else if (in_b[j] < in_a[i])
+         j++;
+      else
+      {
+         out_result[num++] = in_a[i];
+         i++;
+         j++;
+      }
+   }
+   return num;
+}
+
+static int uniteScalar(const int * in_a, int in_numA,
+                       const int * in_b, int in_numB, int * out_result)
+{
+   int i = 0;
+   int j = 0;
+   int num = 0;
+   while (i < in_numA && j < in_numB)
+   {
+      if (in_a[i] < in_b[j])
+         out_result[num++] = in_a[i++];
+      else if (in_b[j] < in_a[i])
+         out_result[num++] = in_b[j++];
+      else
+      {
+         out_result[num++] = in_a[i];
+         i++;
+         j++;
+      }
+   }
+   while (i < in_numA)
+      out_result[num++] = in_a[i++];
+   while (j < in_numB)
+      out_result[num++] = in_b[j++];
+   return num;
+}
+
+static int subtractScalar(const int * in_a, int in_numA,
+                          const int * in_b, int in_numB, int * out_result)
+{
+   int i = 0;
+   int j = 0;
+   int num = 0;
+   while (i < in_numA && j < in_numB)
+   {
+      if (in_a[i] < in_b[j])
+         out_result[num++] = in_a[i++];
+      else if (in_b[j] < in_a[i])
+         j++;
+      else
+      {
+         i++;
+         j++;
+      }
+   }
+   while (i < in_numA)
+      out_result[num++] = in_a[i++];
+   return num;
+}
+
+/******************************************************************************
+ * GALLOP
+ * The first position at or after in_start whose value is at least in_item.
+ * It steps 1, 2, 4, 8... ahead until it passes in_item and then binary
+ * searches the last step, so finding a position d places on costs log d.
+ ******************************************************************************/
+static int gallop(const int * in_data, int in_start, int in_num, int in_item)
+{
+   if (in_start >= in_num || in_data[in_start] >= in_item)
+      return in_start;
+
+   // in_data[in_start + step / 2] is always below in_item
+   int step = 1;
+   while (in_start + step < in_num && in_data[in_start + step] < in_item)
+      step *= 2;
+
+   int low = in_start + step / 2 + 1;
+   int high = std::min(in_start + step, in_num);
+   return (int)(std::lower_bound(in_data + low, in_data + high, in_item) - in_data);
+}
+
+// copies a run of in_num values, returning how many
+static inline int copyRun(const int * in_data, int in_num, int * out_result)
+{
+   if (in_num > 0)
+      memcpy(out_result, in_data, in_num * sizeof(int));
+   return in_num;
+}
+
+/******************************************************************************
+ * INTERSECT / UNITE / SUBTRACT GALLOP
+ * For arrays of very different sizes: each value of the smaller array is
+ * galloped to in the larger, and runs of the larger array are copied whole.
+ ******************************************************************************/
+static int intersectGallop(const int * in_small, int in_numSmall,
+                           const int * in_large, int in_numLarge, int * out_result)
+{
+   int j = 0;
+   int num = 0;
+   for (int i = 0; i < in_numSmall; i++)
+   {
+      j = gallop(in_large, j, in_numLarge, in_small[i]);
+      if (j == in_numLarge)
+         break;
+      if (in_large[j] == in_small[i])
+         out_result[num++] = in_large[j++];
+   }
+   return num;
+}
+
+static int uniteGallop(const int * in_small, int in_numSmall,
+                       const int * in_large, int in_numLarge, int * out_result)
+{
+   int j = 0;
+   int num = 0;
+   for (int i = 0; i < in_numSmall; i++)
+   {
+      int next = gallop(in_large, j, in_numLarge, in_small[i]);
+      num += copyRun(in_large + j, next - j, out_result + num);
+      j = next;
+      if (j < in_numLarge && in_large[j] == in_small[i])
+         j++;
+      out_result[num++] = in_small[i];
+   }
+   return num + copyRun(in_large + j, in_numLarge - j, out_result + num);
+}
+
+// the smaller array is the one being subtracted from
+static int subtractFromSmall(const int * in_a, int in_numA,
+                             const int * in_b, int in_numB, int * out_result)
+{
+   int j = 0;
+   int num = 0;
+   for (int i = 0; i < in_numA; i++)
+   {
+      j = gallop(in_b, j, in_numB, in_a[i]);
+      if (j == in_numB || in_b[j] != in_a[i])
+         out_result[num++] = in_a[i];
+   }
+   return num;
+}
+
+// the smaller array is the one being subtracted
+static int subtractSmall(const int * in_a, int in_numA,
+                         const int * in_b, int in_numB, int * out_result)
+{
+   int i = 0;
+   int num = 0;
+   for (int j = 0; j < in_numB; j++)
+   {
+      int next = gallop(in_a, i, in_numA, in_b[j]);
+      num += copyRun(in_a + i, next - i, out_result + num);
+      i = next;
+      if (i < in_numA && in_a[i] == in_b[j])
+         i++;
+   }
+   return num + copyRun(in_a + i, in_numA - i, out_result + num);
+}
+
+#ifdef SET_KERNELS_X86
+
+/******************************************************************************
+ * MATCH 4 / MATCH 8
+ * Compares every value of one vector with every value of another by
+ * comparing against each rotation of the second. Bit k of the result is set
+ * when lane k of in_a appears anywhere in in_b.
+ ******************************************************************************/
+SET_KERNELS_TARGET("sse4.1")
+static inline int match4(__m128i in_a, __m128i in_b)
+{
+   __m128i equal = _mm_cmpeq_epi32(in_a, in_b);
+   equal = _mm_or_si128(equal, _mm_cmpeq_epi32(in_a,
+                        _mm_shuffle_epi32(in_b, _MM_SHUFFLE(0, 3, 2, 1))));
+   equal = _mm_or_si128(equal, _mm_cmpeq_epi32(in_a,
+                        _mm_shuffle_epi32(in_b, _MM_SHUFFLE(1, 0, 3, 2))));
+   equal = _mm_or_si128(equal, _mm_cmpeq_epi32(in_a,
+                        _mm_shuffle_epi32(in_b, _MM_SHUFFLE(2, 1, 0, 3))));
+   return _mm_movemask_ps(_mm_castsi128_ps(equal));
+}
+
+SET_KERNELS_TARGET("avx2")
+static inline int match8(__m256i in_a, __m256i in_b)
+{
+   const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+   __m256i equal = _mm256_cmpeq_epi32(in_a, in_b);
+   for (int i = 1; i < 8; i++)
+   {
+      in_b = _mm256_permutevar8x32_epi32(in_b, rotate);
+      equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(in_a, in_b));
+   }
+   return _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+}
+
+/******************************************************************************
+ * INTERSECT SSE / INTERSECT AVX2
+ * Compares a block of 4 (or 8) values from each side at once, keeps the
+ * matches, and moves past whichever block ends lower (or both, when they end
+ * on the same value). This replaces the hard to predict branch of the merge
+ * join with one branch per block.
+ ******************************************************************************/
+SET_KERNELS_TARGET("sse4.1")
+static int intersectSse(const int * in_a, int in_numA,
+                        const int * in_b, int in_numB, int * out_result)
+{
+   int i = 0;
+   int j = 0;
+   int num = 0;
+   while (i + 4 <= in_numA && j + 4 <= in_numB)
+   {
+      int mask = match4(_mm_loadu_si128((const __m128i *)(in_a + i)),
+                        _mm_loadu_si128((const __m128i *)(in_b + j)));
+      for (int k = 0; mask; k++, mask >>= 1)
+         if (mask & 1)
+            out_result[num++] = in_a[i + k];
+
+      int lastA = in_a[i + 3];
+      int lastB = in_b[j + 3];
+      if (lastA <= lastB)
+         i += 4;
+      if (lastB <= lastA)
+         j += 4;
+   }
+   return num + intersectScalar(in_a + i, in_numA - i,
+                                in_b + j, in_numB - j, out_result + num);
+}
+
+SET_KERNELS_TARGET("avx2")
+static int intersectAvx2(const int * in_a, int in_numA,
+                         const int * in_b, int in_numB, int * out_result)
+{
+   int i = 0;
+   int j = 0;
+   int num = 0;
+   while (i + 8 <= in_numA && j + 8 <= in_numB)
+   {
+      int mask = match8(_mm256_loadu_si256((const __m256i *)(in_a + i)),
+                        _mm256_loadu_si256((const __m256i *)(in_b + j)));
+      for (int k = 0; mask; k++, mask >>= 1)
+         if (mask & 1)
+            out_result[num++] = in_a[i + k];
+
+      int lastA = in_a[i + 7];
+      int lastB = in_b[j + 7];
+      if (lastA <= lastB)
+         i += 8;
+      if (lastB <= lastA)
+         j += 8;
+   }
+   return num + intersectScalar(in_a + i, in_numA - i,
+                                in_b + j, in_numB - j, out_result + num);
+}
+
+/******************************************************************************
+ * SUBTRACT SSE / SUBTRACT AVX2
+ * Walks the blocks as the intersection does, but collects which values of
+ * the current block of in_a were matched, and writes out the rest once the
+ * block is passed. A block left part way through is finished one value at a
+ * time, since its matched values lie behind the current block of in_b.
+ ******************************************************************************/
+static int finishBlock(const int * in_a, int in_numBlock, int in_found,
+                       const int * in_b, int in_numB, int & io_j,
+                       int * out_result)
+{
+   int num = 0;
+   for (int k = 0; k < in_numBlock; k++)
+   {
+      if ((in_found >> k) & 1)
+         continue;
+      while (io_j < in_numB && in_b[io_j] < in_a[k])
+         io_j++;
+      if (io_j == in_numB || in_b[io_j] != in_a[k])
+         out_result[num++] = in_a[k];
+   }
+   return num;
+}
+
+SET_KERNELS_TARGET("sse4.1")
+static int subtractSse(const int * in_a, int in_numA,
+                       const int * in_b, int in_numB, int * out_result)
+{
+   int i = 0;
+   int j = 0;
+   int num = 0;
+   int found = 0;
+   while (i + 4 <= in_numA && j + 4 <= in_numB)
+   {
+      found |= match4(_mm_loadu_si128((const __m128i *)(in_a + i)),
+                      _mm_loadu_si128((const __m128i *)(in_b + j)));
+
+      int lastA = in_a[i + 3];
+      int lastB = in_b[j + 3];
+      if (lastA <= lastB)
+      {
+         for (int k = 0; k < 4; k++)
+            if (!((found >> k) & 1))
+               out_result[num++] = in_a[i + k];
+         i += 4;
+         found = 0;
+      }
+      if (lastB <= lastA)
+         j += 4;
+   }
+   if (found)
+   {
+      num += finishBlock(in_a + i, 4, found, in_b, in_numB, j, out_result + num);
+      i += 4;
+   }
+   return num + subtractScalar(in_a + i, in_numA - i,
+                               in_b + j, in_numB - j, out_result + num);
+}
+
+SET_KERNELS_TARGET("avx2")
+static int subtractAvx2(const int * in_a, int in_numA,
+                        const int * in_b, int in_numB, int * out_result)
+{
+   int i = 0;
+   int j = 0;
+   int num = 0;
+   int found = 0;
+   while (i + 8 <= in_numA && j + 8 <= in_numB)
+   {
+      found |= match8(_mm256_loadu_si256((const __m256i *)(in_a + i)),
+                      _mm256_loadu_si256((const __m256i *)(in_b + j)));
+
+      int lastA = in_a[i + 7];
+      int lastB = in_b[j + 7];
+      if (lastA <= lastB)
+      {
+         for (int k = 0; k < 8; k++)
+            if (!((found >> k) & 1))
+               out_result[num++] = in_a[i + k];
+         i += 8;
+         found = 0;
+      }
+      if (lastB <= lastA)
+         j += 8;
+   }
+   if (found)
+   {
+      num += finishBlock(in_a + i, 8, found, in_b, in_numB, j, out_result + num);
+      i += 8;
+   }
+   return num + subtractScalar(in_a + i, in_numA - i,
+                               in_b + j, in_numB - j, out_result + num);
+}
+
+/******************************************************************************
+ * MERGE 4
+ * Merges two sorted vectors of 4 into the lowest 4 (out_min) and highest 4
+ * (out_max) of the 8, with a network of min/max steps and no branches
+ ******************************************************************************/
+SET_KERNELS_TARGET("sse4.1")
+static inline void merge4(__m128i in_a, __m128i in_b,
+                          __m128i & out_min, __m128i & out_max)
+{
+   __m128i low = _mm_min_epi32(in_a, in_b);
+   out_max = _mm_max_epi32(in_a, in_b);
+   for (int i = 0; i < 3; i++)
+   {
+      low = _mm_alignr_epi8(low, low, 4);
+      __m128i nextLow = _mm_min_epi32(low, out_max);
+      out_max = _mm_max_epi32(low, out_max);
+      low = nextLow;
+   }
+   out_min = _mm_alignr_epi8(low, low, 4);
+}
+
+// writes the lanes of in_values that differ from the value written before
+static inline int storeUnique(const int * in_values, int * out_result, int in_num)
+{
+   for (int k = 0; k < 4; k++)
+      if (in_num == 0 || out_result[in_num - 1] != in_values[k])
+         out_result[in_num++] = in_values[k];
+   return in_num;
+}
+
+/******************************************************************************
+ * UNITE SSE
+ * Merges a block of 4 at a time: the next block comes from whichever side
+ * has the lower next value, and is merged with the 4 highest values seen so
+ * far. The lower 4 are then written out, dropping repeats. The AVX2 kernels
+ * use this too; a wider merge network does not pay for itself here.
+ ******************************************************************************/
+SET_KERNELS_TARGET("sse4.1")
+static int uniteSse(const int * in_a, int in_numA,
+                    const int * in_b, int in_numB, int * out_result)
+{
+   if (in_numA < 4 || in_numB < 4)
+      return uniteScalar(in_a, in_numA, in_b, in_numB, out_result);
+
+   int lanes[4];
+   __m128i low;
+   __m128i high;
+   merge4(_mm_loadu_si128((const __m128i *)in_a),
+          _mm_loadu_si128((const __m128i *)in_b), low, high);
+   _mm_storeu_si128((__m128i *)lanes, low);
+   int num = storeUnique(lanes, out_result, 0);
+
+   int i = 4;
+   int j = 4;
+   while (i + 4 <= in_numA && j + 4 <= in_numB)
+   {
+      __m128i next;
+      if (in_a[i] <= in_b[j])
+      {
+         next = _mm_loadu_si128((const __m128i *)(in_a + i));
+         i += 4;
+      }
+      else
+      {
+         next = _mm_loadu_si128((const __m128i *)(in_b + j));
+         j += 4;
+      }
+      merge4(next, high, low, high);
+      _mm_storeu_si128((__m128i *)lanes, low);
+      num = storeUnique(lanes, out_result, num);
+   }
+
+   // merge the 4 held back with what remains of both sides
+   _mm_storeu_si128((__m128i *)lanes, high);
+   int h = 0;
+   while (h < 4 || i < in_numA || j < in_numB)
+   {
+      int value;
+      if (h < 4 && (i == in_numA || lanes[h] <= in_a[i]) &&
+                   (j == in_numB || lanes[h] <= in_b[j]))
+         value = lanes[h++];
+      else if (i < in_numA && (j == in_numB || in_a[i] <= in_b[j]))
+         value = in_a[i++];
+      else
+         value = in_b[j++];
+
+      if (out_result[num - 1] != value)
+         out_result[num++] = value;
+   }
+   return num;
+}
+
+/******************************************************************************
+ * HAS SSE41 / HAS AVX2
+ * Does this processor (and, for AVX2, the operating system) support the
+ * instructions?
+ ******************************************************************************/
+static bool hasSse41()
+{
+#ifdef _MSC_VER
+   int info[4];
+   __cpuid(info, 1);
+   return (info[2] >> 19) & 1;
+#else
+   return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+static bool hasAvx2()
+{
+#ifdef _MSC_VER
+   int info[4];
+   __cpuid(info, 1);
+   bool osSavesAvx = ((info[2] >> 27) & 1) && (_xgetbv(0) & 6) == 6;
+   __cpuidex(info, 7, 0);
+   return osSavesAvx && ((info[1] >> 5) & 1);
+#else
+   return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // SET_KERNELS_X86
+
+/******************************************************************************
+ * KERNEL TABLE
+ * The kernels for this processor, chosen the first time they are needed
+ ******************************************************************************/
+struct KernelTable
+{
+   SetKernel intersect;
+   SetKernel unite;
+   SetKernel subtract;
+   const char * name;
+};
+
+static KernelTable chooseKernels()
+{
+   KernelTable table = { intersectScalar, uniteScalar, subtractScalar, "scalar" };
+#ifdef SET_KERNELS_X86
+   if (hasSse41())
+   {
+      KernelTable sse = { intersectSse, uniteSse, subtractSse, "sse4.1" };
+      table = sse;
+      if (hasAvx2())
+      {
+         table.intersect = intersectAvx2;
+         table.subtract = subtractAvx2;
+         table.name = "avx2";
+      }
+   }
+#endif
+   return table;
+}
+
+static const KernelTable & kernels()
+{
+   static const KernelTable table = chooseKernels();
+   return table;
+}
+
+// is one array so much larger than the other that galloping wins?
+static bool isSkewed(int in_numSmall, int in_numLarge)
+{
+   return (long long)in_numSmall * SET_KERNEL_GALLOP_RATIO < in_numLarge;
+}
+
+// are the arrays close enough in size for the vector merge to win?
+static bool isBalanced(int in_numA, int in_numB)
+{
+   return (long long)in_numA * SET_KERNEL_VECTOR_RATIO >= in_numB &&
+          (long long)in_numB * SET_KERNEL_VECTOR_RATIO >= in_numA;
+}
+
+/******************************************************************************
+ * INTERSECT SORTED
+ * The values in both in_a and in_b
+ ******************************************************************************/
+int intersectSorted(const int * in_a, int in_numA,
+                    const int * in_b, int in_numB, int * out_result)
+{
+   if (in_numA == 0 || in_numB == 0)
+      return 0;
+   if (isSkewed(in_numA, in_numB))
+      return intersectGallop(in_a, in_numA, in_b, in_numB, out_result);
+   if (isSkewed(in_numB, in_numA))
+      return intersectGallop(in_b, in_numB, in_a, in_numA, out_result);
+   if (!isBalanced(in_numA, in_numB))
+      return intersectScalar(in_a, in_numA, in_b, in_numB, out_result);
+   return kernels().intersect(in_a, in_numA, in_b, in_numB, out_result);
+}
+
+/******************************************************************************
+ * UNITE SORTED
+ * The values in either in_a or in_b
+ ******************************************************************************/
+int uniteSorted(const int * in_a, int in_numA,
+                const int * in_b, int in_numB, int * out_result)
+{
+   if (isSkewed(in_numA, in_numB))
+      return uniteGallop(in_a, in_numA, in_b, in_numB, out_result);
+   if (isSkewed(in_numB, in_numA))
+      return uniteGallop(in_b, in_numB, in_a, in_numA, out_result);
+   if (!isBalanced(in_numA, in_numB))
+      return uniteScalar(in_a, in_numA, in_b, in_numB, out_result);
+   return kernels().unite(in_a, in_numA, in_b, in_numB, out_result);
+}
+
+/******************************************************************************
+ * SUBTRACT SORTED
+ * The values in in_a that are not in in_b
+ ******************************************************************************/
+int subtractSorted(const int * in_a, int in_numA,
+                   const int * in_b, int in_numB, int * out_result)
+{
+   if (in_numA == 0)
+      return 0;
+   if (isSkewed(in_numA, in_numB))
+      return subtractFromSmall(in_a, in_numA, in_b, in_numB, out_result);
+   if (isSkewed(in_numB, in_numA))
+      return subtractSmall(in_a, in_numA, in_b, in_numB, out_result);
+   return kernels().subtract(in_a, in_numA, in_b, in_numB, out_result);
+}
+
+/******************************************************************************
+ * SET KERNEL NAME
+ * Which kernels this processor runs
+ ******************************************************************************/
+const char * setKernelName()
+{
+   return kernels().name;
+}
@@ -0,0 +1,42 @@
+/***********************************************************************
+* Component:
+*    Week 13, Set Kernels
+* Author:
+*    Matthew Burr
+* Summary:
+*    Intersection, union and difference of sorted int arrays, using
+*    SSE4.1 or AVX2 when the processor has them
+************************************************************************/
+
+#ifndef SETKERNELS_H
+#define SETKERNELS_H
+
+/******************************************************************************
+ * SET KERNELS
+ * Each takes two sorted arrays with no repeated values and writes the
+ * result, also sorted, to out_result, returning how many values it wrote.
+ * out_result needs room for min(in_numA, in_numB) values for an
+ * intersection, in_numA + in_numB for a union, and in_numA for a difference.
+ *
+ * The vector code is chosen the first time a kernel runs, from what the
+ * processor supports. When one array is more than SET_KERNEL_GALLOP_RATIO
+ * times the size of the other, the kernels instead gallop through the larger
+ * one, so the work follows the smaller array. Short of that, intersections
+ * and unions of arrays more than SET_KERNEL_VECTOR_RATIO times apart use the
+ * scalar merge: the vector blocks mostly compare values of the smaller
+ * array it has already passed, while the scalar branches are predictable.
+ ******************************************************************************/
+#define SET_KERNEL_GALLOP_RATIO 64
+#define SET_KERNEL_VECTOR_RATIO 3
+
+int intersectSorted(const int * in_a, int in_numA,
+                    const int * in_b, int in_numB, int * out_result);
+int uniteSorted(const int * in_a, int in_numA,
+                const int * in_b, int in_numB, int * out_result);
+int subtractSorted(const int * in_a, int in_numA,
+                   const int * in_b, int in_numB, int * out_result);
+
+// "avx2", "sse4.1" or "scalar"
+const char * setKernelName();
+
+#endif // SETKERNELS_H
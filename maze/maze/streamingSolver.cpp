@@ -0,0 +1,577 @@
+/***********************************************************************
+* Component:
+*    Week 13, Streaming Solver
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the StreamingMazeSolver class
+************************************************************************/
+
+#include "streamingSolver.h"
+#include "gridGraph.h"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+using namespace std;
+
+// how much of the maze file is read at a time; a row's line that is
+// longer than this makes the buffer grow to fit it
+#define STREAM_CHUNK_SIZE (1 << 20)
+
+// about how many cells findPath() works on at once, whatever the shape of
+// the maze: a band of rows holds this many, or a single row if it is wider
+#define STREAM_BAND_CELLS (1 << 20)
+
+// the distance to a cell no path has reached yet
+#define STREAM_UNREACHED INT_MAX
+
+// find the set an item is in, in a union-find array
+static int findSet(vector<int> & io_sets, int in_item)
+{
+   while (io_sets[in_item] != in_item)
+      in_item = io_sets[in_item] = io_sets[io_sets[in_item]];
+   return in_item;
+}
+
+// move to a byte offset in a file, which may be past 2GB
+static bool seekTo(FILE * in_file, long long in_offset)
+{
+#ifdef _WIN32
+   return _fseeki64(in_file, in_offset, SEEK_SET) == 0;
+#else
+   return fseeko(in_file, (off_t)in_offset, SEEK_SET) == 0;
+#endif
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER CONSTRUCTOR
+ * Reads the maze in in_fileName once, spilling its walls and finding out
+ * whether its ends are connected. Throws if the file can't be read, isn't
+ * a maze, or isn't in row order; parseError() says where a maze went wrong.
+ ******************************************************************************/
+StreamingMazeSolver::StreamingMazeSolver(const char * in_fileName)
+   : m_numCol(0), m_numRow(0), m_isConnected(false), m_hasDistances(false),
+     m_walls(NULL), m_distances(NULL), m_row(0), m_startLabel(-1),
+     m_bandRows(0)
+{
+   m_stats.bytesRead = 0;
+   m_stats.bytesSpilled = 0;
+   m_stats.sweeps = 0;
+   m_stats.bandsSolved = 0;
+   m_parseError.line = 0;
+   m_parseError.column = 0;
+   m_parseError.message = 0;
+
+   FILE * file = fopen(in_fileName, "rb");
+   if (file == NULL)
+      throw "ERROR: Unable to open the maze file.";
+   m_walls = tmpfile();
+   if (m_walls == NULL)
+   {
+      fclose(file);
+      throw "ERROR: Unable to create a spill file.";
+   }
+
+   try
+   {
+      scan(file);
+   }
+   catch (const char *)
+   {
+      fclose(file);
+      fclose(m_walls);
+      throw;
+   }
+   fclose(file);
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER DESTRUCTOR
+ * Closes the spill files, which removes them
+ ******************************************************************************/
+StreamingMazeSolver::~StreamingMazeSolver()
+{
+   if (m_walls != NULL)
+      fclose(m_walls);
+   if (m_distances != NULL)
+      fclose(m_distances);
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER FIND PATH
+ * A shortest path from the top-left cell to the bottom-right one, running
+ * from the end back to the start like Graph::findPath. The first call
+ * works out the distances; later ones only walk them. Throws if there is
+ * no path. Apart from a band of rows while the distances are worked out,
+ * the path itself is the one thing held that can be longer than a row.
+ ******************************************************************************/
+vector<Vertex> StreamingMazeSolver::findPath()
+{
+   if (!m_isConnected)
+      throw "ERROR: No path from source to destination.";
+
+   if (!m_hasDistances)
+   {
+      findDistances();
+      m_hasDistances = true;
+   }
+
+   // walk back from the end with the rows above and below at hand
+   int numCol = m_numCol;
+   vector<unsigned char> wallsAbove(numCol);
+   vector<unsigned char> walls(numCol);
+   vector<unsigned char> wallsBelow(numCol);
+   vector<int> distancesAbove(numCol);
+   vector<int> distances(numCol);
+   vector<int> distancesBelow(numCol);
+
+   int row = m_numRow - 1;
+   int col = numCol - 1;
+   readWalls(row, walls.data());
+   readDistances(row, 1, distances.data());
+   if (row > 0)
+   {
+      readWalls(row - 1, wallsAbove.data());
+      readDistances(row - 1, 1, distancesAbove.data());
+   }
+
+   vector<Vertex> path;
+   path.push_back(Vertex::fromIndex(row * numCol + col));
+   while (row != 0 || col != 0)
+   {
+      int next = distances[col] - 1;
+      if (col > 0 && (walls[col - 1] & OPEN_EAST) && distances[col - 1] == next)
+         col--;
+      else if (col + 1 < numCol && (walls[col] & OPEN_EAST) &&
+               distances[col + 1] == next)
+         col++;
+      else if (row > 0 && (wallsAbove[col] & OPEN_SOUTH) &&
+               distancesAbove[col] == next)
+      {
+         row--;
+         wallsBelow.swap(walls);
+         walls.swap(wallsAbove);
+         distancesBelow.swap(distances);
+         distances.swap(distancesAbove);
+         if (row > 0)
+         {
+            readWalls(row - 1, wallsAbove.data());
+            readDistances(row - 1, 1, distancesAbove.data());
+         }
+      }
+      else
+      {
+         assert(row + 1 < m_numRow && (walls[col] & OPEN_SOUTH) &&
+                distancesBelow[col] == next);
+         row++;
+         wallsAbove.swap(walls);
+         walls.swap(wallsBelow);
+         distancesAbove.swap(distances);
+         distances.swap(distancesBelow);
+         if (row + 1 < m_numRow)
+         {
+            readWalls(row + 1, wallsBelow.data());
+            readDistances(row + 1, 1, distancesBelow.data());
+         }
+      }
+      path.push_back(Vertex::fromIndex(row * numCol + col));
+   }
+   return path;
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER SCAN
+ * Reads the maze a chunk at a time, each chunk cut at the end of its last
+ * whole line, feeding every passage to addPassage
+ ******************************************************************************/
+void StreamingMazeSolver::scan(FILE * in_file)
+{
+   vector<char> buffer(STREAM_CHUNK_SIZE);
+   size_t kept = 0;              // a partial line left from the last chunk
+   bool hasSize = false;
+   MazeParser parser(buffer.data(), buffer.data());
+
+   for (;;)
+   {
+      if (kept == buffer.size())
+         buffer.resize(buffer.size() * 2);
+      size_t got = fread(buffer.data() + kept, 1, buffer.size() - kept, in_file);
+      m_stats.bytesRead += got;
+      size_t size = kept + got;
+      bool isEnd = got == 0;
+
+      size_t complete = size;
+      if (!isEnd)
+         while (complete > 0 && buffer[complete - 1] != '\n')
+            complete--;
+
+      if (complete > 0 || isEnd)
+      {
+         parser.resume(buffer.data(), buffer.data() + complete);
+         if (!hasSize)
+         {
+            if (!parser.readSize(m_numCol, m_numRow))
+            {
+               m_parseError = parser.error();
+               throw "ERROR: Unable to read the size of the maze.";
+            }
+            hasSize = true;
+            m_above.assign(m_numCol, 0);
+            m_openings.assign(m_numCol, 0);
+            m_labels.assign(m_numCol, 0);
+            m_sets.assign(m_numCol * 2, 0);
+            m_relabel.assign(m_numCol * 2, -1);
+            m_packed.assign((m_numCol + 3) / 4, 0);
+         }
+
+         int from;
+         int to;
+         while (parser.readEdge(from, to))
+            if (!addPassage(from, to))
+               return;
+         if (parser.failed())
+         {
+            m_parseError = parser.error();
+            throw "ERROR: Malformed maze file.";
+         }
+      }
+      if (isEnd)
+         break;
+
+      memmove(buffer.data(), buffer.data() + complete, size - complete);
+      kept = size - complete;
+   }
+
+   // the rows after the last passage have none of their own
+   while (m_row < m_numRow)
+      if (!finishRow())
+         return;
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER ADD PASSAGE
+ * Opens the wall between two neighboring cells, first finishing the rows
+ * before the one it belongs to. Returns false once the start is cut off,
+ * since nothing later can change that.
+ ******************************************************************************/
+bool StreamingMazeSolver::addPassage(int in_from, int in_to)
+{
+   int low = in_from < in_to ? in_from : in_to;
+   int high = in_from < in_to ? in_to : in_from;
+   int row = low / m_numCol;
+   int col = low % m_numCol;
+
+   // up and down first, since with one column the cell below is also the
+   // next one
+   unsigned char wall;
+   if (high == low + m_numCol)
+      wall = OPEN_SOUTH;
+   else if (high == low + 1 && col + 1 < m_numCol)
+      wall = OPEN_EAST;
+   else
+      throw "ERROR: A passage joins cells that aren't neighbors.";
+
+   if (row < m_row)
+      throw "ERROR: The maze file is not in row order.";
+   while (m_row < row)
+      if (!finishRow())
+         return false;
+
+   m_openings[col] |= wall;
+   return true;
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER FINISH ROW
+ * The row the scan is on has all its passages: spill its walls, and join
+ * its cells' sets through it. The union-find holds the sets of the row
+ * above, as labels 0 up, and then the row's own cells; joining them through
+ * the passages down and along the row gives the sets this row passes on.
+ * Returns false if the start's set got no further.
+ ******************************************************************************/
+bool StreamingMazeSolver::finishRow()
+{
+   int numCol = m_numCol;
+   assert(m_row < m_numRow);
+
+   for (size_t i = 0; i < m_packed.size(); ++i)
+      m_packed[i] = 0;
+   for (int col = 0; col < numCol; ++col)
+      m_packed[col >> 2] |= m_openings[col] << ((col & 3) << 1);
+   if (fwrite(m_packed.data(), 1, m_packed.size(), m_walls) != m_packed.size())
+      throw "ERROR: Unable to write a spill file.";
+   m_stats.bytesSpilled += m_packed.size();
+
+   for (int i = 0; i < numCol * 2; ++i)
+      m_sets[i] = i;
+   for (int col = 0; col < numCol; ++col)
+      if (m_row > 0 && (m_above[col] & OPEN_SOUTH))
+      {
+         int a = findSet(m_sets, m_labels[col]);
+         int b = findSet(m_sets, numCol + col);
+         if (a != b)
+            m_sets[b] = a;
+      }
+   for (int col = 0; col + 1 < numCol; ++col)
+      if (m_openings[col] & OPEN_EAST)
+      {
+         int a = findSet(m_sets, numCol + col);
+         int b = findSet(m_sets, numCol + col + 1);
+         if (a != b)
+            m_sets[b] = a;
+      }
+
+   // the start is the first cell of the first row, and after that
+   // whatever set it was passed down in
+   int start = m_row == 0 ? numCol : m_startLabel;
+   int startSet = start == -1 ? -1 : findSet(m_sets, start);
+
+   int next = 0;
+   for (int col = 0; col < numCol; ++col)
+   {
+      int set = findSet(m_sets, numCol + col);
+      if (m_relabel[set] == -1)
+         m_relabel[set] = next++;
+      m_labels[col] = m_relabel[set];
+   }
+   m_startLabel = startSet == -1 ? -1 : m_relabel[startSet];
+   for (int col = 0; col < numCol; ++col)
+      m_relabel[findSet(m_sets, numCol + col)] = -1;
+
+   bool isLastRow = m_row == m_numRow - 1;
+   if (isLastRow)
+      m_isConnected = m_startLabel != -1 &&
+                      m_labels[numCol - 1] == m_startLabel;
+
+   m_above.swap(m_openings);
+   for (int col = 0; col < numCol; ++col)
+      m_openings[col] = 0;
+   m_row++;
+   return isLastRow || m_startLabel != -1;
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER FIND DISTANCES
+ * Fills the distances spill file with every cell's distance from the start.
+ * The bands are solved down the maze and then up it, over and over, each
+ * only if it or a neighbor changed since it was last solved; once a whole
+ * pass changes nothing, every passage agrees with the distances on either
+ * side of it, so they are the shortest.
+ ******************************************************************************/
+void StreamingMazeSolver::findDistances()
+{
+   m_distances = tmpfile();
+   if (m_distances == NULL)
+      throw "ERROR: Unable to create a spill file.";
+
+   m_bandRows = STREAM_BAND_CELLS / m_numCol;
+   if (m_bandRows < 1)
+      m_bandRows = 1;
+   if (m_bandRows > m_numRow)
+      m_bandRows = m_numRow;
+   int numBands = (m_numRow + m_bandRows - 1) / m_bandRows;
+   m_bandWalls.resize((size_t)m_bandRows * m_numCol);
+   m_bandDistances.resize((size_t)m_bandRows * m_numCol);
+   m_queue.resize((size_t)m_bandRows * m_numCol);
+
+   // when each band was last solved, -1 if never, and when it last changed;
+   // the clock ticks once a band
+   vector<int> solvedAt(numBands, -1);
+   vector<int> changedAt(numBands, 0);
+   int clock = 0;
+
+   bool isDown = true;
+   for (bool isChanged = true; isChanged; isDown = !isDown)
+   {
+      isChanged = false;
+      m_stats.sweeps++;
+      for (int i = 0; i < numBands; ++i)
+      {
+         int band = isDown ? i : numBands - 1 - i;
+         int latest = changedAt[band];
+         if (band > 0 && changedAt[band - 1] > latest)
+            latest = changedAt[band - 1];
+         if (band + 1 < numBands && changedAt[band + 1] > latest)
+            latest = changedAt[band + 1];
+         if (latest <= solvedAt[band])
+            continue;
+
+         bool isBandChanged = solveBand(band, solvedAt[band] == -1,
+                                        band > 0 && solvedAt[band - 1] != -1,
+                                        band + 1 < numBands &&
+                                           solvedAt[band + 1] != -1);
+         solvedAt[band] = ++clock;
+         if (isBandChanged)
+         {
+            changedAt[band] = clock;
+            isChanged = true;
+         }
+      }
+   }
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER SOLVE BAND
+ * Brings one band's distances up to date with the rows just above and below
+ * it, in_hasAbove and in_hasBelow saying whether those have been solved
+ * yet. The cells those rows make nearer are the seeds: breadth-first from
+ * them, taken nearest first and merged with the queue, which stays in
+ * order of distance, spreads what they gained through the band. The rest
+ * of the band already agreed with itself. A new band starts unreached, but
+ * for the start. Returns whether any distance got shorter.
+ ******************************************************************************/
+bool StreamingMazeSolver::solveBand(int in_band, bool in_isNew,
+                                    bool in_hasAbove, bool in_hasBelow)
+{
+   int numCol = m_numCol;
+   int first = in_band * m_bandRows;
+   int numRows = m_numRow - first < m_bandRows ? m_numRow - first : m_bandRows;
+   int numCells = numRows * numCol;
+   unsigned char * walls = m_bandWalls.data();
+   int * distances = m_bandDistances.data();
+   m_stats.bandsSolved++;
+
+   for (int row = 0; row < numRows; ++row)
+      readWalls(first + row, walls + row * numCol);
+   if (in_isNew)
+      for (int i = 0; i < numCells; ++i)
+         distances[i] = STREAM_UNREACHED;
+   else
+      readDistances(first, numRows, distances);
+
+   // the seeds, as distance and cell
+   vector<pair<int, int> > seeds;
+   if (in_isNew && first == 0)
+   {
+      distances[0] = 0;
+      seeds.push_back(make_pair(0, 0));
+   }
+
+   vector<unsigned char> across(numCol);
+   vector<int> acrossDistances(numCol);
+   if (in_hasAbove)
+   {
+      readWalls(first - 1, across.data());
+      readDistances(first - 1, 1, acrossDistances.data());
+      for (int col = 0; col < numCol; ++col)
+         if ((across[col] & OPEN_SOUTH) &&
+             acrossDistances[col] != STREAM_UNREACHED &&
+             acrossDistances[col] + 1 < distances[col])
+         {
+            distances[col] = acrossDistances[col] + 1;
+            seeds.push_back(make_pair(distances[col], col));
+         }
+   }
+   if (in_hasBelow)
+   {
+      int last = (numRows - 1) * numCol;
+      readDistances(first + numRows, 1, acrossDistances.data());
+      for (int col = 0; col < numCol; ++col)
+         if ((walls[last + col] & OPEN_SOUTH) &&
+             acrossDistances[col] != STREAM_UNREACHED &&
+             acrossDistances[col] + 1 < distances[last + col])
+         {
+            distances[last + col] = acrossDistances[col] + 1;
+            seeds.push_back(make_pair(distances[last + col], last + col));
+         }
+   }
+   if (seeds.empty())
+   {
+      if (in_isNew)
+         writeDistances(first, numRows, distances);
+      return false;
+   }
+   sort(seeds.begin(), seeds.end());
+
+   // a seed whose distance has since got shorter was reached some other way
+   int * queue = m_queue.data();
+   int head = 0;
+   int tail = 0;
+   size_t nextSeed = 0;
+   while (head < tail || nextSeed < seeds.size())
+   {
+      int cell;
+      if (head == tail ||
+          (nextSeed < seeds.size() &&
+           seeds[nextSeed].first <= distances[queue[head]]))
+      {
+         cell = seeds[nextSeed].second;
+         if (distances[cell] != seeds[nextSeed++].first)
+            continue;
+      }
+      else
+         cell = queue[head++];
+
+      int next = distances[cell] + 1;
+      int col = cell % numCol;
+      if (col + 1 < numCol && (walls[cell] & OPEN_EAST) &&
+          next < distances[cell + 1])
+      {
+         distances[cell + 1] = next;
+         queue[tail++] = cell + 1;
+      }
+      if (col > 0 && (walls[cell - 1] & OPEN_EAST) &&
+          next < distances[cell - 1])
+      {
+         distances[cell - 1] = next;
+         queue[tail++] = cell - 1;
+      }
+      if (cell + numCol < numCells && (walls[cell] & OPEN_SOUTH) &&
+          next < distances[cell + numCol])
+      {
+         distances[cell + numCol] = next;
+         queue[tail++] = cell + numCol;
+      }
+      if (cell >= numCol && (walls[cell - numCol] & OPEN_SOUTH) &&
+          next < distances[cell - numCol])
+      {
+         distances[cell - numCol] = next;
+         queue[tail++] = cell - numCol;
+      }
+   }
+
+   writeDistances(first, numRows, distances);
+   return true;
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER READ WALLS
+ * Unpacks one row of the walls spill file into OPEN_EAST and OPEN_SOUTH
+ * bits, a byte a cell
+ ******************************************************************************/
+void StreamingMazeSolver::readWalls(int in_row, unsigned char * out_openings)
+{
+   if (!seekTo(m_walls, (long long)in_row * m_packed.size()) ||
+       fread(m_packed.data(), 1, m_packed.size(), m_walls) != m_packed.size())
+      throw "ERROR: Unable to read a spill file.";
+   for (int col = 0; col < m_numCol; ++col)
+      out_openings[col] = (m_packed[col >> 2] >> ((col & 3) << 1)) & 3;
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER READ DISTANCES
+ * Reads in_numRows rows of the distances spill file, from in_row on
+ ******************************************************************************/
+void StreamingMazeSolver::readDistances(int in_row, int in_numRows,
+                                        int * out_distances)
+{
+   size_t count = (size_t)in_numRows * m_numCol;
+   if (!seekTo(m_distances, (long long)in_row * m_numCol * sizeof(int)) ||
+       fread(out_distances, sizeof(int), count, m_distances) != count)
+      throw "ERROR: Unable to read a spill file.";
+}
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER WRITE DISTANCES
+ * Writes in_numRows rows of the distances spill file, from in_row on
+ ******************************************************************************/
+void StreamingMazeSolver::writeDistances(int in_row, int in_numRows,
+                                         const int * in_distances)
+{
+   size_t count = (size_t)in_numRows * m_numCol;
+   if (!seekTo(m_distances, (long long)in_row * m_numCol * sizeof(int)) ||
+       fwrite(in_distances, sizeof(int), count, m_distances) != count)
+      throw "ERROR: Unable to write a spill file.";
+   m_stats.bytesSpilled += (long long)count * sizeof(int);
+}
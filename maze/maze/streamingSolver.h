@@ -0,0 +1,109 @@
+/***********************************************************************
+* Component:
+*    Week 13, Streaming Solver
+* Author:
+*    Matthew Burr
+* Summary:
+*    Solves a maze straight from its text file, a row at a time, for
+*    mazes whose graph is too big to hold in memory
+************************************************************************/
+
+#ifndef STREAMINGSOLVER_H
+#define STREAMINGSOLVER_H
+
+#include "mazeParser.h"
+#include "vertex.h"
+#include <cstdio>
+#include <vector>
+
+/******************************************************************************
+ * STREAMING SOLVE STATS
+ * What a StreamingMazeSolver has done
+ ******************************************************************************/
+struct StreamingSolveStats
+{
+   long long bytesRead;       // of the maze file
+   long long bytesSpilled;    // written to the spill files
+   int sweeps;                // passes over the bands of the maze
+   int bandsSolved;           // bands those passes had to solve
+};
+
+/******************************************************************************
+ * STREAMING MAZE SOLVER
+ * Solves a text maze in row order, as MazeGenerator::write produces: every
+ * passage, whichever way it is written, is listed with the other passages
+ * out of its upper or left cell's row, and the rows come top to bottom.
+ * Passages go both ways. Only a few rows, or one band of rows, are ever
+ * held, so memory doesn't grow with the height.
+ *
+ * The constructor reads the file once. It packs each row's walls, two bits
+ * a cell, into a spill file and sweeps a union-find over the row: the sets
+ * are the cells joined through the rows so far, so when the last row is
+ * done, isConnected() knows whether the top-left cell can reach the
+ * bottom-right one, the ends Graph::findPath() uses. The read stops early
+ * once the start's set has no cell left in the row.
+ *
+ * findPath() then needs distances, which it keeps in a second spill file.
+ * It works on bands of rows, as many as fit in about STREAM_BAND_CELLS
+ * cells, or one row if a row is wider. A band takes whatever shorter
+ * distances the rows just above and below it offer through the passages
+ * between them, then spreads them through itself breadth-first, starting
+ * from the nearest. Bands are solved down the maze, then up, then down,
+ * each only if a neighbor changed since it was last solved, until nothing
+ * changes. A maze that fits in one band is solved in one go; a taller one
+ * needs another pass each time its shortest paths double back across a
+ * band. Then it walks back from the end, always to a neighbor one step
+ * nearer the start, keeping just three rows at hand. The path is a
+ * shortest one; in a perfect maze it is the only one.
+ ******************************************************************************/
+class StreamingMazeSolver
+{
+public:
+   StreamingMazeSolver(const char * in_fileName);
+   ~StreamingMazeSolver();
+
+   int numCol() const { return m_numCol; }
+   int numRow() const { return m_numRow; }
+   bool isConnected() const { return m_isConnected; }
+   std::vector<Vertex> findPath();
+
+   const StreamingSolveStats & stats() const { return m_stats; }
+   const ParseError & parseError() const { return m_parseError; }
+
+private:
+   StreamingMazeSolver(const StreamingMazeSolver &);
+   StreamingMazeSolver & operator = (const StreamingMazeSolver &);
+
+   void scan(FILE * in_file);
+   bool addPassage(int in_from, int in_to);
+   bool finishRow();
+   void findDistances();
+   bool solveBand(int in_band, bool in_isNew, bool in_hasAbove,
+                  bool in_hasBelow);
+   void readWalls(int in_row, unsigned char * out_openings);
+   void readDistances(int in_row, int in_numRows, int * out_distances);
+   void writeDistances(int in_row, int in_numRows, const int * in_distances);
+
+   int m_numCol;
+   int m_numRow;
+   bool m_isConnected;
+   bool m_hasDistances;
+   FILE * m_walls;                        // two bits a cell, row by row
+   FILE * m_distances;                    // an int a cell, row by row
+   int m_row;                             // the row the scan is on
+   std::vector<unsigned char> m_openings; // its openings so far, and
+   std::vector<unsigned char> m_above;    // those of the row above
+   std::vector<int> m_labels;             // the row above's sets, 0 up
+   int m_startLabel;                      // the start's set there, or -1
+   std::vector<int> m_sets;               // union-find: the labels, then
+   std::vector<int> m_relabel;            // this row's cells
+   std::vector<unsigned char> m_packed;   // rows of m_walls, as stored
+   int m_bandRows;                        // rows in a band
+   std::vector<unsigned char> m_bandWalls;
+   std::vector<int> m_bandDistances;
+   std::vector<int> m_queue;
+   StreamingSolveStats m_stats;
+   ParseError m_parseError;
+};
+
+#endif // STREAMINGSOLVER_H
@@ -0,0 +1,159 @@
+/***********************************************************************
+* Component:
+*    Week 13, Thread Pool
+* Author:
+*    Matthew Burr
+* Summary:
+*    Implements the ThreadPool class
+************************************************************************/
+
+#include "threadPool.h"
+#include <cassert>
+using namespace std;
+
+/******************************************************************************
+ * THREAD POOL CONSTRUCTOR
+ * Starts in_numThreads workers, or one per core if in_numThreads is 0
+ ******************************************************************************/
+ThreadPool::ThreadPool(int in_numThreads)
+   : m_queued(0), m_unfinished(0), m_sleeping(0), m_nextQueue(0),
+     m_stopping(false)
+{
+   assert(in_numThreads >= 0);
+   if (in_numThreads == 0)
+      in_numThreads = (int)thread::hardware_concurrency();
+   if (in_numThreads <= 0)
+      in_numThreads = 1;
+
+   for (int i = 0; i < in_numThreads; ++i)
+      m_queues.push_back(new WorkerQueue);
+   for (int i = 0; i < in_numThreads; ++i)
+      m_threads.push_back(thread(&ThreadPool::run, this, i));
+}
+
+/******************************************************************************
+ * THREAD POOL DESTRUCTOR
+ * Finishes any outstanding tasks, then stops the workers
+ ******************************************************************************/
+ThreadPool::~ThreadPool()
+{
+   wait();
+   {
+      lock_guard<mutex> guard(m_lock);
+      m_stopping = true;
+   }
+   m_wake.notify_all();
+
+   for (size_t i = 0; i < m_threads.size(); ++i)
+      m_threads[i].join();
+   for (size_t i = 0; i < m_queues.size(); ++i)
+      delete m_queues[i];
+}
+
+/******************************************************************************
+ * THREAD POOL SUBMIT
+ * Queues a task on the next worker in turn, waking a worker only if one is
+ * asleep. Tasks must not throw.
+ ******************************************************************************/
+void ThreadPool::submit(const Task & in_task)
+{
+   WorkerQueue & queue = *m_queues[m_nextQueue++ % m_queues.size()];
+   m_unfinished++;
+   {
+      lock_guard<mutex> guard(queue.lock);
+      queue.tasks.push_back(in_task);
+      m_queued++;
+   }
+
+   // a worker counts itself asleep under m_lock before it checks m_queued
+   // for the last time, so either it sees this task or we see it; taking
+   // the lock waits for it to be inside wait() before we notify
+   if (m_sleeping > 0)
+   {
+      lock_guard<mutex> guard(m_lock);
+   }
+   m_wake.notify_one();
+}
+
+/******************************************************************************
+ * THREAD POOL WAIT
+ * Blocks until every task submitted so far has finished
+ ******************************************************************************/
+void ThreadPool::wait()
+{
+   unique_lock<mutex> guard(m_lock);
+   while (m_unfinished > 0)
+      m_idle.wait(guard);
+}
+
+/******************************************************************************
+ * THREAD POOL RUN
+ * The body of each worker: take tasks until there are none, then sleep
+ * until one is queued, until the pool is stopped
+ ******************************************************************************/
+void ThreadPool::run(int in_worker)
+{
+   Task task;
+   while (true)
+   {
+      if (takeTask(in_worker, task))
+      {
+         task(in_worker);
+         task = Task();
+         if (--m_unfinished == 0)
+         {
+            lock_guard<mutex> guard(m_lock);
+            m_idle.notify_all();
+         }
+         continue;
+      }
+
+      // every queue looked empty; a task queued since is counted in
+      // m_queued, so look again only if there is one
+      unique_lock<mutex> guard(m_lock);
+      m_sleeping++;
+      while (m_queued == 0 && !m_stopping)
+         m_wake.wait(guard);
+      m_sleeping--;
+      if (m_queued == 0 && m_stopping)
+         return;
+   }
+}
+
+/******************************************************************************
+ * THREAD POOL TAKE TASK
+ * Takes the newest task from this worker's own queue, or failing that
+ * steals the oldest task from another worker's queue. m_queued changes
+ * under the queue's lock along with the queue, so it never counts a task
+ * that has already been taken.
+ ******************************************************************************/
+bool ThreadPool::takeTask(int in_worker, Task & out_task)
+{
+   {
+      WorkerQueue & own = *m_queues[in_worker];
+      lock_guard<mutex> guard(own.lock);
+      if (!own.tasks.empty())
+      {
+         out_task = own.tasks.back();
+         own.tasks.pop_back();
+         m_queued--;
+         return true;
+      }
+   }
+
+   // m_queues is complete before any worker starts; m_threads may not be
+   int numQueues = (int)m_queues.size();
+   for (int i = 1; i < numQueues; ++i)
+   {
+      WorkerQueue & victim = *m_queues[(in_worker + i) % numQueues];
+      lock_guard<mutex> guard(victim.lock);
+      if (!victim.tasks.empty())
+      {
+         out_task = victim.tasks.front();
+         victim.tasks.pop_front();
+         m_queued--;
+         return true;
+      }
+   }
+   return false;
+}
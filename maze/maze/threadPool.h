@@ -0,0 +1,70 @@
+/***********************************************************************
+* Component:
+*    Week 13, Thread Pool
+* Author:
+*    Matthew Burr
+* Summary:
+*    A fixed set of worker threads that share out tasks by work stealing
+************************************************************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/******************************************************************************
+ * THREAD POOL
+ * Runs submitted tasks on a fixed set of worker threads. Every worker has
+ * its own task queue; tasks are dealt out to the queues in turn, each worker
+ * takes work from the back of its own queue, and a worker whose queue is
+ * empty steals from the front of another's. A task is told the index of the
+ * worker running it, so callers can keep scratch state per worker. The
+ * counts of tasks are atomic, so a task that doesn't find a worker asleep
+ * only ever takes its queue's lock; the pool's lock is for sleeping and
+ * waking alone.
+ ******************************************************************************/
+class ThreadPool
+{
+public:
+   typedef std::function<void(int)> Task;
+
+   ThreadPool(int in_numThreads = 0);
+   ~ThreadPool();
+
+   int size() const { return (int)m_threads.size(); }
+   void submit(const Task & in_task);
+   void wait();
+
+private:
+   // one worker's queue of tasks, guarded by its own lock
+   struct WorkerQueue
+   {
+      std::mutex lock;
+      std::deque<Task> tasks;
+   };
+
+   void run(int in_worker);
+   bool takeTask(int in_worker, Task & out_task);
+
+   ThreadPool(const ThreadPool &);
+   ThreadPool & operator = (const ThreadPool &);
+
+   std::vector<std::thread> m_threads;
+   std::vector<WorkerQueue *> m_queues;
+   std::atomic<int> m_queued;          // tasks waiting in any queue
+   std::atomic<int> m_unfinished;      // tasks submitted but not yet finished
+   std::atomic<int> m_sleeping;        // workers waiting on m_wake
+   std::atomic<unsigned> m_nextQueue;
+   std::mutex m_lock;                  // only for sleeping and waking, and
+   bool m_stopping;                    // guards this
+   std::condition_variable m_wake;     // signalled when there is work to do
+   std::condition_variable m_idle;     // signalled when all the work is done
+};
+
+#endif // THREADPOOL_H
@@ -15,8 +15,13 @@
 #include <string>
 #include <cctype>
 #include <cassert>
+#include <climits>
 using std::string;
 
+// what graphs and their searches store for a vertex: just the index, four
+// bytes with no virtual table, so arrays of them can be copied as raw memory
+typedef int VertexId;
+
 /********************************************************
  * VERTEX
  * A generic Vertex class serving as a base class
@@ -28,6 +33,10 @@ public:
    Vertex() : i(0)          {             }
    Vertex(int index) : i(0) { set(index); }
    Vertex(const Vertex & v) { i = v.i;    }
+
+   // a vertex for an index its graph has already checked (no validation
+   // against the shared max, so graphs of any size can use it)
+   static Vertex fromIndex(int index) { Vertex v; v.i = index; return v; }
  
    // set (the validation part)
    bool set(int index) { 
@@ -68,7 +77,8 @@ public:
    
 protected:
    int i;
-   static int max;
+   static int max;   // shared by every vertex: only change it while no
+                     // other thread is using vertices
 };
 
 /**************************************************
@@ -204,6 +214,89 @@ private:
    }
 };
 
+// longest coordinate text, such as "fxshrxw2147483647", plus one spare
+#define COORDINATE_TEXT_MAX 24
+
+/***********************************************
+ * FORMAT COORDINATE
+ * Write a coordinate as text the way a spreadsheet
+ * does: the column as letters (a .. z, then aa, ab
+ * and so on) and the row as a number from 1. Returns
+ * the number of characters written to text, which
+ * must hold COORDINATE_TEXT_MAX. (1,3) --> "b4"
+ ***********************************************/
+inline int formatCoordinate(int col, int row, char * text)
+{
+   assert(col >= 0 && row >= 0 && row < INT_MAX);
+
+   // the letters come out last first
+   char letters[8];
+   int numLetters = 0;
+   unsigned int c = (unsigned int)col + 1;
+   while (c > 0)
+   {
+      c--;
+      letters[numLetters++] = (char)('a' + c % 26);
+      c /= 26;
+   }
+
+   char digits[12];
+   int numDigits = 0;
+   unsigned int r = (unsigned int)row + 1;
+   do
+   {
+      digits[numDigits++] = (char)('0' + r % 10);
+      r /= 10;
+   }
+   while (r > 0);
+
+   int length = 0;
+   while (numLetters > 0)
+      text[length++] = letters[--numLetters];
+   while (numDigits > 0)
+      text[length++] = digits[--numDigits];
+   return length;
+}
+
+/***********************************************
+ * PARSE COORDINATE
+ * Read the text from begin up to end as column
+ * letters followed by a row number, as written by
+ * formatCoordinate. Stops at the first character
+ * that isn't part of the coordinate and leaves
+ * begin pointing there. "aa120" --> (26,119)
+ ***********************************************/
+inline bool parseCoordinate(const char * & begin, const char * end,
+                            int & col, int & row)
+{
+   const char * p = begin;
+   long long c = 0;
+   while (p < end && *p >= 'a' && *p <= 'z')
+   {
+      c = c * 26 + (*p++ - 'a' + 1);
+      if (c > INT_MAX)
+         return false;
+   }
+   if (p == begin)
+      return false;
+
+   const char * digits = p;
+   long long r = 0;
+   while (p < end && *p >= '0' && *p <= '9')
+   {
+      r = r * 10 + (*p++ - '0');
+      if (r > INT_MAX)
+         return false;
+   }
+   if (p == digits || r == 0)
+      return false;
+
+   col = (int)(c - 1);
+   row = (int)(r - 1);
+   begin = p;
+   return true;
+}
+
 /***********************************************
  * COORDIANTES VERTEX
  * Verticies that are identified by coordinates on a grid
@@ -230,32 +323,21 @@ public:
    }
    
    
-   // return the text version of the index: (1,3) --> b4
+   // return the text version of the index: (1,3) --> b4, (26,119) --> aa120
    string getText() const
    {
-      string s;
-      // column is letter a .. z (or whatever)
-      // row is number 1 ... 100 (or whatever)
-      s += (char)(getCol() + 'a');
-      if (getRow() < 9)
-         s += (char)(getRow() + '1');
-      else
-      {
-         assert((getRow() + 1) / 10 >= 0 && (getRow() + 1) / 10 <= 9);
-         assert((getRow() + 1) % 10 >= 0 && (getRow() + 1) % 10 <= 9);         
-         s += (char)((getRow() + 1) / 10 + '0');
-         s += (char)((getRow() + 1) % 10 + '0');
-      }
-      return s;
+      char text[COORDINATE_TEXT_MAX];
+      return string(text, formatCoordinate(getCol(), getRow(), text));
    }
    
    // set an index based on the text: b4 --> (1,3)
    bool setText(const string & s)
    {
-      if (s.size() == 2)
-         return set(s[0] - 'a', s[1] - '1');
-      else
-         return set(s[0] - 'a', (s[1] - '0') * 10 + (s[2] - '0') - 1);
+      int col;
+      int row;
+      const char * p = s.data();
+      const char * end = p + s.size();
+      return parseCoordinate(p, end, col, row) && p == end && set(col, row);
    }
 
    // get the column and row from the current index
@@ -267,13 +349,13 @@ public:
    // set the max row
    void setMax(int col, int row)
    {
-      assert(col > 0 && row > 0 && col < 26 && row < 100);
+      assert(col > 0 && row > 0 && row <= INT_MAX / col);
       maxCol = col;
       max    = col * row;
    }
 
 private:
-   static int maxCol;
+   static int maxCol;   // shared like max
 };
 
 
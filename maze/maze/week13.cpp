@@ -16,6 +16,8 @@
 #include "graph.h"       // for Graph class which should be in graph.h
 #include "vertex.h"      // for Vertex, LVertex, and CVertex
 #include "maze.h"
+#include "courseSchedule.h"
+#include "benchmarks.h"
 using namespace std;
 
 int Vertex::max = 10;
@@ -48,6 +50,13 @@ int main()
    cout << "\t3. Determine if two verticies are connected\n";
    cout << "\t4. Find all the verticies connected to a given vertex\n";
    cout << "\ta. Maze\n";
+   cout << "\tb. Convert a maze to the binary format\n";
+   cout << "\tg. Generate a random maze\n";
+   cout << "\ts. Solve a maze too big to load\n";
+   cout << "\tc. Schedule the courses of curricula\n";
+   cout << "\tr. Time repairing paths against searching again\n";
+   cout << "\tp. Time the maze parser against ifstream\n";
+   cout << "\tk. Time the set kernels against a plain merge\n";
 
    // select
    char choice;
@@ -58,6 +67,27 @@ int main()
       case 'a':
          solveMaze();
          break;
+      case 'b':
+         convertMazeToBinary();
+         break;
+      case 'g':
+         generateMaze();
+         break;
+      case 's':
+         solveMazeStreaming();
+         break;
+      case 'c':
+         planSemesters();
+         break;
+      case 'r':
+         benchmarkDynamicPaths();
+         break;
+      case 'p':
+         benchmarkParser();
+         break;
+      case 'k':
+         benchmarkSetKernels();
+         break;
       case '1':
          testSimple();
          cout << "Test 1 complete\n";
@@ -196,9 +226,10 @@ void testQuery()
       g2 = g1;
       g1.clear();
 
-      // need some variables
+      // need some variables, sized to the maze we read
       CVertex vFrom;
       CVertex vTo;
+      vFrom.setMax(g2.numCol(), g2.numRow());
    
       // allow the user to prompt for verticies  
       cout << "Determine if a given edge exists in the graph\n";